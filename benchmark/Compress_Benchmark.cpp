@@ -0,0 +1,237 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/benchmark/Compress_Benchmark.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+/*
+ * Compares the per node compression of zlib with zstd and a trained
+ * dictionary. The samples are the .xml node files of the directory given
+ * as the argument, or generated nodes without one. Every other sample is
+ * used for the training, all of them are compressed.
+ *
+ * g++ -std=c++17 -O2 -D_ZSTD -Iinclude benchmark/Compress_Benchmark.cpp source/Compress_zstd.cpp -lzstd -lz
+ */
+
+#include <Compress_zstd.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct Benchmark_Result
+{
+	size_t size;
+	double compress_seconds;
+	double decompress_seconds;
+	bool valid;
+};
+
+static std::vector<std::string> samples_read(const std::string &directory)
+{
+	std::vector<std::string> samples;
+
+	for(auto &entry : std::filesystem::directory_iterator(directory))
+	{
+		if(entry.path().extension() == ".xml")
+		{
+			std::ifstream file(entry.path(), std::ios::binary);
+			samples.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		}
+	}
+
+	return samples;
+}
+
+// Nodes alike the ones of Node::xml_create(), the Base64 texts vary
+static std::vector<std::string> samples_generate(size_t count)
+{
+	static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::vector<std::string> samples;
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+
+	auto text = [&](size_t size)
+	{
+		std::string value;
+
+		for(size_t i = 0; i < size; i++)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			value += alphabet[(state >> 33) % 64];
+		}
+
+		return value;
+	};
+
+	for(size_t i = 0; i < count; i++)
+	{
+		samples.push_back("<Node><PrivateIDVarint>" + text(4) + "</PrivateIDVarint><NodeInfo><Name>" + text(12) +
+				"</Name><Info>" + text(8) + "</Info><Memo>" + text(24 + i % 40) + "</Memo></NodeInfo>"
+				"<Flags>AAAAAA==</Flags><Position>" + text(16) + "</Position><Rotation>" + text(16) +
+				"</Rotation><Scale>AACAPwAAgD8AAIA/</Scale><Mesh>" + text(8) + "</Mesh></Node>");
+	}
+
+	return samples;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static Benchmark_Result benchmark_zlib(const std::vector<std::string> &samples)
+{
+	Benchmark_Result result = {0, 0.0, 0.0, true};
+	std::vector<std::string> compressed(samples.size());
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < samples.size(); i++)
+	{
+		uLongf size = compressBound(samples[i].size());
+		compressed[i].resize(size);
+		compress2((Bytef*)&compressed[i][0], &size, (const Bytef*)samples[i].data(), samples[i].size(), Z_DEFAULT_COMPRESSION);
+		compressed[i].resize(size);
+		result.size += size;
+	}
+
+	result.compress_seconds = seconds_since(start);
+
+	std::string output;
+	start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < samples.size(); i++)
+	{
+		uLongf size = samples[i].size();
+		output.resize(size);
+
+		if(uncompress((Bytef*)&output[0], &size, (const Bytef*)compressed[i].data(), compressed[i].size()) != Z_OK ||
+				output != samples[i])
+		{
+			result.valid = false;
+		}
+	}
+
+	result.decompress_seconds = seconds_since(start);
+
+	return result;
+}
+
+static Benchmark_Result benchmark_zstd(const std::vector<std::string> &samples, Zstd_Dictionary &dictionary)
+{
+	Benchmark_Result result = {0, 0.0, 0.0, true};
+	std::vector<std::string> compressed(samples.size());
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < samples.size(); i++)
+	{
+		if(dictionary.compress(samples[i], compressed[i]) == EXIT_FAILURE)
+		{
+			result.valid = false;
+		}
+
+		result.size += compressed[i].size();
+	}
+
+	result.compress_seconds = seconds_since(start);
+
+	std::string output;
+	start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < samples.size(); i++)
+	{
+		if(dictionary.decompress(compressed[i], output) == EXIT_FAILURE || output != samples[i])
+		{
+			result.valid = false;
+		}
+	}
+
+	result.decompress_seconds = seconds_since(start);
+
+	return result;
+}
+
+static void result_print(const char *name, const Benchmark_Result &result, size_t raw_size)
+{
+	double megabytes = double(raw_size) / (1024.0 * 1024.0);
+
+	std::printf("%-12s %12zu bytes  ratio %6.2f  compress %8.1f MB/s  decompress %8.1f MB/s%s\n",
+			name, result.size, double(raw_size) / double(result.size ? result.size : 1),
+			megabytes / (result.compress_seconds > 0.0 ? result.compress_seconds : 1e-9),
+			megabytes / (result.decompress_seconds > 0.0 ? result.decompress_seconds : 1e-9),
+			result.valid ? "" : "  FAILED");
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> samples = argc > 1 ? samples_read(argv[1]) : samples_generate(20000);
+	size_t raw_size = 0;
+
+	for(const std::string &sample : samples)
+	{
+		raw_size += sample.size();
+	}
+
+	if(samples.empty())
+	{
+		std::fprintf(stderr, "No .xml files\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> training;
+
+	for(size_t i = 0; i < samples.size(); i += 2)
+	{
+		training.push_back(samples[i]);
+	}
+
+	Zstd_Dictionary plain;
+	Zstd_Dictionary trained;
+
+	if(trained.train(training) == EXIT_FAILURE)
+	{
+		std::fprintf(stderr, "Training the dictionary failed, too few samples?\n");
+		return EXIT_FAILURE;
+	}
+
+	std::printf("%zu nodes, %zu bytes, dictionary of %zu samples\n", samples.size(), raw_size, training.size());
+	result_print("zlib", benchmark_zlib(samples), raw_size);
+	result_print("zstd", benchmark_zstd(samples, plain), raw_size);
+	result_print("zstd+dict", benchmark_zstd(samples, trained), raw_size);
+
+	return EXIT_SUCCESS;
+}
@@ -1,7 +1,10 @@
 #ifndef _BASE64
 #define _BASE64
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstddef>
+#include <functional>
 //#define TEXT(x) x     //Not unicode
 
 
@@ -9,8 +12,83 @@ const static char encodeLookup[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqr
 const static char padCharacter = '=';
 
 std::basic_string<char> base64Encode(std::vector<unsigned char> inputBuffer);
+// Encodes input_size bytes to output, which has to hold ((input_size + 2) / 3) * 4 chars. Returns the count of written chars.
+size_t base64Encode(const unsigned char *input, size_t input_size, char *output);
 std::vector<unsigned char> base64Decode(const std::basic_string<char> input);
 
-std::string Base64_get_string(const std::basic_string<char> input);
-std::string Base64_encode_string(std::string input);
+// Exact count of chars written by base64Encode() for input_size bytes
+size_t base64EncodedLength(size_t input_size);
+// Exact count of bytes written by base64Decode() for the input, 0 if the length is not valid
+size_t base64DecodedLength(std::string_view input);
+
+// Decodes input to output, which has to hold (input.size() / 4) * 3 bytes. Returns EXIT_SUCCESS or EXIT_FAILURE.
+int base64Decode(std::string_view input, unsigned char *output, size_t *output_size);
+
+// Replaces the content of output, capacity of output is reused
+void base64Encode(std::string_view input, std::string &output);
+int base64Decode(std::string_view input, std::string &output);
+
+std::string Base64_get_string(std::string_view input);
+std::string Base64_encode_string(std::string_view input);
+
+/*
+ * Incremental encoder, input can be given in chunks of any size with
+ * update(). Encoded text is given to the sink in blocks of at most
+ * chunk_size chars, the block is null terminated. finish() flushes
+ * the rest with the padding.
+ */
+class Base64_Encoder
+{
+public:
+  typedef std::function<void(const char *data, size_t size)> Sink;
+
+  Base64_Encoder(Sink output_sink, size_t chunk_size = 16384);
+
+  void update(const unsigned char *input, size_t input_size);
+  void update(std::string_view input);
+  void finish();
+
+  size_t get_written();
+
+private:
+  void flush();
+
+  Sink sink;
+  std::vector<char> buffer;
+  size_t buffer_size;
+  unsigned char carry[3];
+  size_t carry_size;
+  size_t written;
+};
+
+/*
+ * Incremental decoder, the counterpart of Base64_Encoder.
+ * update() and finish() return EXIT_FAILURE on invalid input,
+ * after that the rest of the input is ignored.
+ */
+class Base64_Decoder
+{
+public:
+  typedef std::function<void(const unsigned char *data, size_t size)> Sink;
+
+  Base64_Decoder(Sink output_sink, size_t chunk_size = 16384);
+
+  int update(const char *input, size_t input_size);
+  int update(std::string_view input);
+  int finish();
+
+  size_t get_written();
+
+private:
+  int decode(const char *input, size_t input_size);
+
+  Sink sink;
+  std::vector<unsigned char> buffer;
+  size_t chunk_chars;
+  char carry[4];
+  size_t carry_size;
+  size_t written;
+  bool padded;
+  bool failed;
+};
 #endif
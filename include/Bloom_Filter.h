@@ -0,0 +1,72 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Bloom_Filter.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __BLOOM_FILTER
+#define __BLOOM_FILTER
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Set of 64 bit keys, which can answer only "maybe" or "surely not".
+ * Sized for capacity keys at the false positive rate, with more keys
+ * the rate grows. Keys can not be removed, see reset().
+ */
+class Bloom_Filter
+{
+public:
+	Bloom_Filter();
+
+	// Clears the filter and sizes it again
+	void reset(size_t capacity, double false_positive_rate = 0.01);
+	void clear();
+
+	void add(uint64_t key);
+	// false only when the key has surely not been added
+	bool contains(uint64_t key) const;
+
+	size_t get_count() const;
+	size_t get_capacity() const;
+	size_t get_memory() const;
+
+private:
+	std::vector<uint64_t> bits;
+	uint64_t mask;
+	unsigned int hash_count;
+	size_t count;
+	size_t capacity;
+};
+
+#endif
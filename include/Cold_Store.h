@@ -0,0 +1,97 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Cold_Store.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __COLD_STORE
+#define __COLD_STORE
+
+#include <Common_Types.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Compressed copies of serialized nodes in memory, keyed by privateID.
+ * With _LZ4 the data is LZ4 compressed, else it is stored as it is.
+ * Over the budget the oldest entries are dropped, so only data, which
+ * can be read again from elsewhere, should be put here.
+ */
+class Cold_Store
+{
+public:
+	Cold_Store();
+
+	// 0 drops everything and keeps the store empty
+	void set_budget(size_t budget);
+	size_t get_budget() const;
+
+	// Replaces the earlier entry of privateID
+	int put(Type_ID privateID, std::string_view data);
+	// Decompresses the entry to data and removes it
+	int take(Type_ID privateID, std::string &data);
+	bool contains(Type_ID privateID) const;
+	void remove(Type_ID privateID);
+	void clear();
+
+	size_t get_count() const;
+	// Bytes used by the entries and the size of their data uncompressed
+	size_t get_memory() const;
+	size_t get_size() const;
+	uint64_t get_drops() const;
+
+private:
+	struct Entry
+	{
+		std::string data;
+		size_t size;
+		uint64_t order;
+	};
+
+	void entry_erase(std::unordered_map<Type_ID, Entry>::iterator entry);
+	void drop_oldest();
+
+	std::unordered_map<Type_ID, Entry> entries;
+	// Insertion order, pairs of replaced and removed entries are skipped
+	std::deque<std::pair<Type_ID, uint64_t>> order;
+	uint64_t order_next;
+
+	size_t budget;
+	size_t memory;
+	size_t size;
+	uint64_t drops;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Compress_zstd.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __COMPRESS_ZSTD
+#define __COMPRESS_ZSTD
+
+#ifdef _ZSTD
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+#ifndef ZSTD_DECOMPRESS_MAX_SIZE
+// Frames claiming a bigger content are refused, the size is read from the frame
+#define ZSTD_DECOMPRESS_MAX_SIZE (size_t(64) * 1024 * 1024)
+#endif
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+/*
+ * zstd compression with a dictionary, for the small xml documents of
+ * single nodes, which share most of their tags with each other.
+ * The dictionary is trained from samples of the nodes and stored as a
+ * file next to the node files. Without a dictionary plain zstd is used.
+ * The contexts are reused, so one dictionary is used from one thread.
+ *
+ * A dictionary replaced by set() or train() is kept for decompression,
+ * frames of dictionaries not in memory are read from previous_file().
+ */
+class Zstd_Dictionary
+{
+public:
+	Zstd_Dictionary();
+	~Zstd_Dictionary();
+
+	Zstd_Dictionary(const Zstd_Dictionary &) = delete;
+	Zstd_Dictionary &operator=(const Zstd_Dictionary &) = delete;
+
+	int train(const std::vector<std::string> &samples, size_t dictionary_size = 16384);
+	int set(std::string_view dictionary);
+	void clear();
+
+	int file_read(const std::string &path);
+	int file_write(const std::string &path);
+
+	bool is_loaded();
+	unsigned int get_id();
+
+	// Earlier dictionaries are looked for in path + id + ".zstd"
+	void set_previous_path(const std::string &path);
+	std::string previous_file(unsigned int dictionary_id);
+
+	// Replaces the content of output
+	int compress(std::string_view input, std::string &output);
+	int decompress(std::string_view input, std::string &output);
+
+	int level;
+
+private:
+	int contexts_create();
+	void current_clear(bool keep_previous);
+	ZSTD_DDict_s *previous_get(unsigned int dictionary_id);
+
+	std::string data;
+	unsigned int id;
+
+	// nullptr, when the file of the id could not be read
+	std::unordered_map<unsigned int, ZSTD_DDict_s*> previous;
+	std::string previous_path;
+
+	ZSTD_CCtx_s *compress_context;
+	ZSTD_DCtx_s *decompress_context;
+	ZSTD_CDict_s *compress_dictionary;
+	ZSTD_DDict_s *decompress_dictionary;
+};
+#endif
+#endif
@@ -0,0 +1,121 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Directory_Index.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __DIRECTORY_INDEX
+#define __DIRECTORY_INDEX
+
+#include <Common_Types.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+struct Directory_Index_Entry
+{
+	Type_ID privateID;
+	std::string name;
+	uint64_t size;
+	// Nanoseconds of the file system clock
+	int64_t mtime;
+	uint64_t hash;
+};
+
+/*
+ * Node files of one directory with their privateIDs, kept in a file so
+ * that the directory is not listed and the file names are not parsed
+ * on every start. The directory is scanned again only when its mtime
+ * has changed, that is when files are created, renamed or removed.
+ * Files rewritten in place by others are not noticed.
+ *
+ * Single changes are appended to a journal file next to it, file_write()
+ * merges them. Both files are rewritten in place, so that writing them
+ * does not change the mtime of the directory.
+ */
+class Directory_Index
+{
+public:
+	Directory_Index();
+
+	void clear();
+
+	/*
+	 * Node files are named prefix + Base64 privateID + suffix. Returns
+	 * EXIT_FAILURE if the directory can not be read. Only new and changed
+	 * files are hashed.
+	 */
+	int update(const std::string &directory, const std::string &prefix, const std::string &suffix);
+
+	// Reads the index and replays its journal
+	int file_read(const std::string &path);
+	// Whole index, the journal is emptied
+	int file_write(const std::string &path);
+	// Appends the changes since the last read or write to the journal
+	int file_update(const std::string &path);
+
+	/*
+	 * After name has been written to or removed from directory. The index
+	 * has to be brought up to date with update() before, then the new mtime
+	 * of the directory is taken as the one of the index.
+	 */
+	void file_written(const std::string &directory, const std::string &name, Type_ID privateID, std::string_view content);
+	void file_removed(const std::string &directory, Type_ID privateID);
+
+	// Sorted by privateID
+	const std::vector<Directory_Index_Entry> &get_entries() const;
+	const Directory_Index_Entry *find(Type_ID privateID) const;
+
+	bool is_modified() const;
+	// Grows each time update() scans the directory again
+	uint64_t get_scan_count() const;
+
+	// FNV-1a 64 of the content
+	static uint64_t content_hash(std::string_view data);
+
+private:
+	void directory_touched(const std::string &directory);
+	int journal_replay(const std::vector<unsigned char> &data);
+
+	std::vector<Directory_Index_Entry> entries;
+	int64_t directory_mtime;
+	std::string directory_scanned;
+	bool modified;
+	uint64_t scan_count;
+
+	// Records not yet appended to the journal file
+	std::vector<unsigned char> journal;
+	size_t file_size;
+	size_t journal_file_size;
+};
+
+#endif
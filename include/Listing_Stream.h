@@ -0,0 +1,128 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Listing_Stream.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __LISTING_STREAM
+#define __LISTING_STREAM
+
+#if defined(_ZLIB) || defined(_ZSTD)
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Binary listing file, where the xml of the whole listing is compressed
+ * in frames and written raw, without Base64.
+ *
+ * header : "LSTM", version, codec, 2 reserved bytes
+ * frames : compressed xml fragments, every fragment is whole in one frame
+ * tables : for each frame offset, compressed and uncompressed size,
+ *          for each keyed fragment key, frame, offset and size
+ * footer : offset of the tables, frame count, fragment count, "LSTE"
+ *
+ * The numbers are little-endian. The tables make it possible to read
+ * one fragment, for example a node by its privateID, by decompressing
+ * only its frame.
+ */
+#define LISTING_STREAM_VERSION 1
+#define LISTING_STREAM_CODEC_ZLIB 1
+#define LISTING_STREAM_CODEC_ZSTD 2
+
+struct Listing_Stream_Frame
+{
+	uint64_t offset;
+	uint32_t compressed_size;
+	uint32_t size;
+};
+
+struct Listing_Stream_Entry
+{
+	uint64_t key;
+	uint32_t frame;
+	uint32_t offset;
+	uint32_t size;
+};
+
+class Listing_Stream_Writer
+{
+public:
+	Listing_Stream_Writer(size_t frame_size = 65536);
+
+	int open(const std::string &path);
+	// Key 0 is not added to the tables
+	int append(std::string_view xml, uint64_t key);
+	int close();
+
+private:
+	int frame_flush();
+
+	std::ofstream file;
+	std::string frame;
+	std::string compressed;
+	std::vector<Listing_Stream_Frame> frames;
+	std::vector<Listing_Stream_Entry> entries;
+	size_t frame_size;
+	uint64_t position;
+	unsigned char codec;
+	bool failed;
+};
+
+class Listing_Stream_Reader
+{
+public:
+	Listing_Stream_Reader();
+
+	int open(const std::string &path);
+	void close();
+
+	size_t get_frame_count();
+
+	// Uncompressed xml of the frame, which is a sequence of whole fragments
+	int frame_read(size_t index, std::string &xml);
+	// Fragment stored with the key, the last read frame is kept for the next call
+	int find(uint64_t key, std::string &xml);
+
+private:
+	std::ifstream file;
+	std::string compressed;
+	std::string frame;
+	std::vector<Listing_Stream_Frame> frames;
+	std::vector<Listing_Stream_Entry> entries;
+	size_t frame_index;
+	unsigned char codec;
+};
+#endif
+#endif
@@ -37,6 +37,7 @@
 
 #include <Node.h>
 #include <cstdlib>
+#include <cstring>
 
 #ifdef _SQL_DATABASE
 #include <SQL/SQL_Database.h>
@@ -49,6 +50,26 @@
 #include <Base64.h>
 #include <Sync_Table.h>
 #include <Node_Info.h>
+#include <Node_Fields.h>
+#include <Manager_Snapshot.h>
+#include <Name_Index.h>
+#include <Text_Index.h>
+#include <Cold_Store.h>
+#include <Bloom_Filter.h>
+#include <Directory_Index.h>
+#include <memory>
+#include <unordered_map>
+#include <future>
+#include <functional>
+#include <algorithm>
+
+#ifdef _ZSTD
+#include <Compress_zstd.h>
+#endif
+
+#if defined(_ZLIB) || defined(_ZSTD)
+#include <Listing_Stream.h>
+#endif
 
 #ifndef ANDROID
 #if __has_include(<filesystem>)
@@ -92,6 +113,21 @@ public:
 
 		this->is_child_manager = false;
 		this->all_files_read = false;
+		this->name_index_enabled = false;
+		this->text_index_enabled = false;
+		this->resident_budget = 0;
+		this->resident_memory = 0;
+		this->resident_hand = 0;
+		this->resident_removed = 0;
+		this->resident_hits = 0;
+		this->resident_loads = 0;
+		this->resident_evictions = 0;
+		this->cold_hits = 0;
+		this->prefetch_depth = 0;
+		this->prefetch_max = 16;
+		this->privateID_filter_enabled = false;
+		this->privateID_filter_valid = false;
+		this->directory_index_enabled = false;
 		this->manager_init();
 	}
 
@@ -100,6 +136,14 @@ public:
 		this->nextID = 0;
 		this->counter = 0;
 		this->remove_unneeded = false;
+		this->xml_path_valid = false;
+		this->snapshot_counter = 0;
+		this->name_index.clear();
+		this->text_index_checked = false;
+		this->directory_index_checked = false;
+#ifdef _ZSTD
+		this->xml_dictionary_checked = false;
+#endif
 		this->clear_pointers();
 		this->clear_current_values();
 
@@ -120,7 +164,7 @@ public:
 	{
 		this->clear();
 
-		this->delete_nodes();
+		this->delete_nodes(false);
 		this->clear_pointers();
 		this->clear_current_values();
 		this->all_files_read = false;
@@ -631,11 +675,22 @@ public:
 			}
 
 			if(in_memory_only == false){
+				if(this->prefetch_reads.empty() == false)
+				{
+					this->prefetch_poll();
+				}
+
 				T *temp = this->_get_pointer_of_privateID(id);
 
 				if(temp == nullptr)
 				{
-					temp = this->load_file(id);
+					temp = this->privateID_load(id);
+				}
+
+				else if(this->resident_budget != 0)
+				{
+					this->resident_hits++;
+					this->residency_reference(temp);
 				}
 
 				/*
@@ -645,24 +700,12 @@ public:
 						  }
 						  */
 
-
-#ifdef _SQL_DATABASE
-
-				if(temp == nullptr &&
-		#ifdef _FLOVER_
-						this->flover->options->database_location == Data_Location::SQL)
-#else
-						this->flover->sync_table.target_sql)
-#endif
-				{
-					temp = this->database_get_by_privateID(id);
-				}
-
-#endif
-
+				// Pinned until returned, loads into this manager while it syncs must not evict it
 				if(temp != nullptr)
 				{
+					temp->pins++;
 					temp->sync(this->flover->sync_table);
+					temp->pins--;
 				}
 
 				return temp;
@@ -750,14 +793,31 @@ public:
 			this->xml_file_delete_by_privateID(node->privateID);
 		}
 
+		if(node->pins != 0)
+		{
+			node->node_flags.bit_set(Node_Flags::Delete_Node, true);
+			return EXIT_FAILURE;
+		}
+
 		node->sanitize();
 
 		// this->database_delete_by_privateID(node->sqlID);
 		return this->_del(node);
 	}
 
+	/*
+	 * Pinned nodes are not deleted, del() and delete_unneeded() leave them
+	 * marked with Delete_Node until the depency batches pinning them are
+	 * resolved, see depency_batch_add().
+	 */
 	int _del(T *node)
 	{
+		if(node->pins != 0)
+		{
+			node->node_flags.bit_set(Node_Flags::Delete_Node, true);
+			return EXIT_FAILURE;
+		}
+
 		T *temp_find = this->first;
 
 		while(temp_find != nullptr)
@@ -796,7 +856,11 @@ public:
 				}
 
 				this->counter--;
+				this->indexes_remove(temp);
 				delete temp;
+#ifdef _NODE_INFO_COMPACT
+				this->string_pool.collect_needed();
+#endif
 				return EXIT_SUCCESS;
 			}
 
@@ -808,1226 +872,3191 @@ public:
 
 	T *load_file(Type_ID privateID)
 	{
-		std::string filename;
-
-#ifdef _FLOVER_
-		filename = this->flover->options->get_xml_path() + this->xml_node_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(privateID)) + XML_STRING_FILENAME_EXTENSION_XML;
-#else
-		filename = this->xml_node_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(privateID)) + XML_STRING_FILENAME_EXTENSION_XML;
-#endif
-
-		return this->xml_node_parse(file_read_text(this->flover->sync_table, filename));
+		return this->load_file(privateID, this->load_options);
 	}
 
-	T *create(bool set_privateID = false)
+	T *load_file(Type_ID privateID, Node_Load_Options &options)
 	{
-		T *new_node = new T(this->get_next_id());
-		this->add_to_last(new_node);
-		this->counter++;
+		// The copy in memory would be older than the node read now
+		this->cold_store.remove(privateID);
 
-		if(set_privateID)
+		if(this->prefetch_reads.count(privateID) != 0)
 		{
-			new_node->privateID = this->seek_next_ongoing_privateID();
+			return this->prefetch_parse(privateID, options);
 		}
 
-		give_pointers(new_node);
-
-		new_node->node_flags.bit_set(Node_Flags::Needed, true);
-		new_node->node_flags.bit_set(Node_Flags::To_Delete, false);
+		T *node = this->xml_node_parse(file_read_text(this->flover->sync_table, this->xml_file_path(privateID)), options);
 
-		this->xml_set_node_settings(new_node);
+		if(node != nullptr && this->prefetch_depth != 0)
+		{
+			node->depency_prefetch(this->prefetch_depth);
+		}
 
-		return new_node;
+		return node;
 	}
 
-	T *create_no_id()
+	/*
+	 * Filter of the privateIDs, which have a node file or a row in the
+	 * database, so that get_pointer_of_privateID() does not try to read
+	 * missing nodes. It is built from the directory index, the directory
+	 * listing or the database, when first needed, and nodes written by
+	 * this manager are added to it. Misses cost no I/O, files made by
+	 * others are found once the directory index sees the mtime of the
+	 * directory change, or after xml_path_reset().
+	 */
+	void privateID_filter_enable(bool enable = true)
 	{
-		T *new_object = new T(0);
-		this->counter++;
-		give_pointers(new_object);
-		this->add_to_last(new_object);
-		return new_object;
+		this->privateID_filter_enabled = enable;
+		this->privateID_filter_valid = false;
 	}
 
-	virtual void give_pointers(T *node)
+	int privateID_filter_build()
 	{
-		if(node != nullptr)
+		this->privateID_filter_valid = false;
+
+#ifdef _SQL_DATABASE
+	#ifdef _FLOVER_
+		if(this->flover->options->database_location == Data_Location::SQL)
+#else
+		if(this->flover->sync_table.target_sql)
+#endif
 		{
-			return void();
+			std::vector<Type_ID> ids;
+
+			if(this->database_get_privateIDs(&ids) == EXIT_FAILURE)
+			{
+				return EXIT_FAILURE;
+			}
+
+			this->privateID_filter.reset(std::max<size_t>(ids.size() * 2, 1024));
+
+			for(Type_ID id : ids)
+			{
+				this->privateID_filter.add(uint64_t(id));
+			}
+
+			this->privateID_filter_valid = true;
+
+			return EXIT_SUCCESS;
 		}
-	}
+#endif
 
-	int delete_nodes()
-	{
-		T *temp = nullptr;
-		T *temp_delete = nullptr;
-		temp = this->first;
+		Directory_Index *index = this->directory_index_get();
 
-		if(temp != nullptr)
+		if(index != nullptr)
 		{
-			while(temp != nullptr)
+			this->privateID_filter.reset(std::max<size_t>(index->get_entries().size() * 2, 1024));
+
+			for(const Directory_Index_Entry &entry : index->get_entries())
 			{
-				temp_delete = temp;
+				this->privateID_filter.add(uint64_t(entry.privateID));
+			}
 
-#ifdef _FLOVER_
-				temp_delete->unsync(this->flover->sync_table);
-#endif
+			this->privateID_filter_valid = true;
 
-				temp = temp->next;
-				delete temp_delete;
+			return EXIT_SUCCESS;
+		}
+
+		std::vector<std::string> files;
+
+		if(directory_listing_get(this->xml_directory_path(), &files) == EXIT_FAILURE)
+		{
+			files.clear();
+		}
+
+		// Room to grow, it is built again when full
+		this->privateID_filter.reset(std::max<size_t>(files.size() * 2, 1024));
+
+		std::string prefix = this->xml_node_name + XML_STRING_UNDERSCORE;
+		std::string suffix = XML_STRING_FILENAME_EXTENSION_XML;
+
+		for(const std::string &file : files)
+		{
+			std::string_view name(file);
+			name = name.substr(name.find_last_of('/') + 1);
+
+			if(name.size() <= prefix.size() + suffix.size() ||
+					name.compare(0, prefix.size(), prefix) != 0 ||
+					name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+			{
+				continue;
 			}
 
-			this->counter = 0;
-			this->first = nullptr;
-			this->last = nullptr;
+			std::string encoded(name.substr(prefix.size(), name.size() - prefix.size() - suffix.size()));
+			std::vector<unsigned char> raw = base64Decode(encoded);
 
-			this->all_files_read = false;
-			this->clear_current_values();
+			if(raw.size() == sizeof(Type_ID))
+			{
+				this->privateID_filter.add(uint64_t(uchar_to_variable<Type_ID>(raw)));
+			}
+		}
 
-			return EXIT_SUCCESS;
+		this->privateID_filter_valid = true;
+
+		return EXIT_SUCCESS;
+	}
+
+	// false, when there is surely no file for privateID
+	bool privateID_filter_may_exist(Type_ID privateID)
+	{
+		this->xml_path_check();
+
+		if(this->privateID_filter_enabled == false)
+		{
+			return true;
 		}
 
+		if(this->privateID_filter_valid == false && this->privateID_filter_build() == EXIT_FAILURE)
+		{
+			return true;
+		}
 
-		return EXIT_FAILURE;
+		return this->privateID_filter.contains(uint64_t(privateID));
 	}
 
-	int delete_node_by_privateID(Type_ID id,  bool delete_file = false)
+	/*
+	 * Index of the node files kept in directory_index_path(), used instead
+	 * of listing the directory when all files are read, the listing is made
+	 * or the privateID filter is built. The directory is listed again only
+	 * when its mtime has changed.
+	 */
+	void directory_index_enable(bool enable = true)
 	{
-		return this->del(this->_get_pointer_of_privateID(id), delete_file);
+		this->directory_index_enabled = enable;
+		this->directory_index_checked = false;
 	}
 
-	int delete_node_by_id( Type_ID id,  bool delete_file = false)
+	bool directory_index_is_enabled()
 	{
-		return this->del(this->get_pointer_of_id(id), delete_file);
+		return this->directory_index_enabled;
 	}
 
-	void add_to_last(T *node)
+	std::string directory_index_path()
 	{
-		if(this->first == nullptr && this->last == nullptr)
+		return this->xml_directory_path() + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + "directory.idx";
+	}
+
+	// Brought up to date with the directory, nullptr when disabled or the directory can not be read
+	Directory_Index *directory_index_get()
+	{
+		if(this->directory_index_enabled == false)
 		{
-			this->first = node;
-			this->last = node;
-			node->prev = nullptr;
-			node->next = nullptr;
+			return nullptr;
 		}
 
-		else
+#ifdef _SQL_DATABASE
+#ifdef _FLOVER_
+		if(this->flover->options->database_location == Data_Location::SQL)
 		{
-			node->prev = this->last;
-			this->last->next = node;
-			this->last = this->last->next;
-			this->last->next = nullptr;
+			return nullptr;
 		}
-	}
+#endif
+#endif
 
-	virtual void set_nodes_to_unneeded(bool value = false)
-	{
-		T *temp = this->first;
+		this->xml_path_check();
 
-		while(temp != nullptr)
+		if(this->directory_index_checked == false)
 		{
-			temp->set_needed(value);
-			temp = temp->next;
+			this->directory_index.file_read(this->directory_index_path());
+			this->directory_index_checked = true;
 		}
-	}
 
-	virtual void delete_unneeded()
-	{
-		T *temp = this->first;
+		uint64_t scans = this->directory_index.get_scan_count();
 
-		if(temp != nullptr)
+		if(this->directory_index.update(this->xml_directory_path(), this->xml_node_name + XML_STRING_UNDERSCORE, XML_STRING_FILENAME_EXTENSION_XML) == EXIT_FAILURE)
 		{
-			while(temp != nullptr)
-			{
-				if(temp->node_flags.bit_get(Node_Flags::Needed) == false ||
-						temp->node_flags.bit_get(Node_Flags::Delete_Node))
-				{
-					T *temp_delete = temp;
-					temp->runtime_clear();
-					temp = temp->next;
+			return nullptr;
+		}
 
-					this->_del(temp_delete);
-				}
+		// Files were created or removed by others, the privateID filter may miss them
+		if(this->directory_index.get_scan_count() != scans)
+		{
+			this->privateID_filter_valid = false;
+		}
 
-				else
-				{
-					temp->delete_unneeded_content();
-					temp = temp->next;
-				}
-			}
+		this->directory_index_save();
 
-			this->all_files_read = false;
-		}
+		return &this->directory_index;
 	}
 
-	virtual int unsync_manager(Sync_Table &table)
+	int directory_index_save()
 	{
-		T *node = this->first;
-
-		if(node != nullptr)
+		if(this->directory_index_enabled == false || this->directory_index_checked == false || this->directory_index.is_modified() == false)
 		{
-			while(node != nullptr)
-			{
-				node->unsync(table);
-				node = node->next;
-			}
-
 			return EXIT_SUCCESS;
 		}
 
-		return EXIT_FAILURE;
+		return this->directory_index.file_write(this->directory_index_path());
 	}
 
-	virtual int unsync_manager()
+	// Appends the single changes to the journal of the index, instead of writing it whole
+	int directory_index_journal()
 	{
-		T *node = this->first;
-
-		if(node != nullptr)
+		if(this->directory_index_enabled == false || this->directory_index_checked == false || this->directory_index.is_modified() == false)
 		{
-			while(node != nullptr)
-			{
-				node->unsync(this->flover->sync_table);
-				node = node->next;
-			}
-
 			return EXIT_SUCCESS;
 		}
 
-		return EXIT_FAILURE;
+		return this->directory_index.file_update(this->directory_index_path());
 	}
 
-	int sync_all(Sync_Table &table)
+	/*
+	 * Depth of the depency prefetch, 0 disables it. A node read by
+	 * load_file() queues background reads of the files of its depencies,
+	 * which queue those of theirs, down to depth. At most max_reads files
+	 * are read at once. The files are parsed on the thread of the manager,
+	 * by prefetch_poll() or when the node is asked for.
+	 */
+	void prefetch_depth_set(unsigned int depth, size_t max_reads = 16)
 	{
-		T *node = this->first;
+		this->prefetch_depth = depth;
+		this->prefetch_max = max_reads;
+	}
 
-		if(node != nullptr)
-		{
-			while(node != nullptr)
-			{
-				node->sync(table);
-				node = node->next;
-			}
+	unsigned int prefetch_depth_get()
+	{
+		return this->prefetch_depth;
+	}
 
-			return EXIT_SUCCESS;
+	// Queues a background read of the file of privateID, if the node is not in memory
+	void prefetch(Type_ID privateID, unsigned int depth)
+	{
+		if(depth == 0 || privateID == 0 || this->prefetch_reads.size() >= this->prefetch_max ||
+				this->prefetch_reads.count(privateID) != 0 || this->cold_store.contains(privateID) ||
+				this->privateID_filter_may_exist(privateID) == false ||
+				this->_get_pointer_of_privateID(privateID) != nullptr)
+		{
+			return void();
 		}
 
-		return EXIT_FAILURE;
+		this->prefetch_read(privateID, depth);
 	}
 
-	int sync_all()
+	// Parses the files read so far, their depencies are queued in turn
+	void prefetch_poll()
 	{
-		T *node = this->first;
+		std::vector<Type_ID> ready;
 
-		if(node != nullptr)
+		for(auto &read : this->prefetch_reads)
 		{
-			while(node != nullptr)
+			if(read.second.xml.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
 			{
-				node->sync(this->flover->sync_table);
-				node = node->next;
+				ready.push_back(read.first);
 			}
-
-			return EXIT_SUCCESS;
 		}
 
-		return EXIT_FAILURE;
+		for(Type_ID privateID : ready)
+		{
+			T *node = this->prefetch_parse(privateID, this->load_options);
+
+			if(node != nullptr && this->resident_budget != 0)
+			{
+				this->residency_add(node);
+			}
+		}
 	}
 
-	int node_exists(T *node)
+	// Waits for all of the queued reads, also the ones queued meanwhile
+	void prefetch_wait()
 	{
-		if(node != nullptr)
+		while(this->prefetch_reads.empty() == false)
 		{
-			T *temp = this->first;
+			Type_ID privateID = this->prefetch_reads.begin()->first;
+			T *node = this->prefetch_parse(privateID, this->load_options);
 
-			while(temp != nullptr)
+			if(node != nullptr && this->resident_budget != 0)
 			{
-				if(node == temp)
-				{
-					return EXIT_SUCCESS;
-				}
-
-				temp = temp->next;
+				this->residency_add(node);
 			}
 		}
-
-		return EXIT_FAILURE;
 	}
 
-#ifdef _SQL_DATABASE
-	int database_delete(T *node)
+	/*
+	 * Batched resolution of depencies. Node_Depency::collect() queues a
+	 * depency pointing into this manager, depency_batch_resolve() looks
+	 * up all of them at once and hands each its node, or nullptr.
+	 * owner_pins are the Node::pins of the node having the depency, it is
+	 * not evicted or deleted until then, see _del(). The requests of owners
+	 * freed by the destructor of this manager are dropped, the managers
+	 * of owners in other managers have to stay.
+	 */
+	void depency_batch_add(Type_ID privateID, unsigned int *owner_pins, std::function<void(T *node)> resolve)
 	{
-#ifdef _FLOVER_
-		if(this->flover->sql_database != nullptr)
+		Depency_Request request;
+		request.privateID = privateID;
+		request.owner_pins = owner_pins;
+		request.resolve = std::move(resolve);
+
+		if(owner_pins != nullptr)
 		{
-			if(this->flover->sql_database->connected)
-			{
-				if(this->flover->sql_database->make_query(this->query_create_delete_by_id(node->sqlID)) == EXIT_SUCCESS)
-				{
-					return EXIT_SUCCESS;
-				}
-			}
+			(*owner_pins)++;
 		}
-#endif
-		return EXIT_FAILURE;
+
+		this->depency_batch.push_back(std::move(request));
 	}
 
-	int database_delete_by_privateID( Type_ID privateID)
+	// Queues the unresolved depencies of all nodes, see Node::depency_collect()
+	void depency_batch_collect()
 	{
-		if(this->sql_database != nullptr)
+		for(T *node = this->first; node != nullptr; node = node->next)
 		{
-			if(this->sql_database->connected)
-			{
-				return this->sql_database->make_query(this->query_create_delete_by_privateID(privateID));
-			}
+			node->depency_collect();
 		}
-
-		return EXIT_FAILURE;
 	}
 
-	int database_save(T *node)
+	/*
+	 * Every privateID is looked up once. The nodes in memory are found in
+	 * one pass over the list, the files of the others are read together in
+	 * the background, prefetch_max at a time. Returns the count of the
+	 * depencies, which got a node.
+	 */
+	size_t depency_batch_resolve()
 	{
-#ifdef _FLOVER_
-		if(this->flover->sql_database != nullptr)
+		if(this->depency_batch.empty())
 		{
-			if(this->flover->sql_database->connected)
-			{
-				if(this->flover->sql_database->make_query(this->query_create_save(node)) == EXIT_SUCCESS)
-				{
-					return EXIT_SUCCESS;
-				}
-			}
+			return 0;
 		}
-#endif
 
-		return EXIT_FAILURE;
-	}
-
-	int database_update(T *node)
-	{
-		if(this->sql_database != nullptr)
+		if(this->prefetch_reads.empty() == false)
 		{
-			if(this->sql_database->connected)
-			{
-				if(this->sql_database->make_query(this->query_create_update(node)) == EXIT_SUCCESS)
-				{
-					return EXIT_SUCCESS;
-				}
-			}
+			this->prefetch_poll();
 		}
 
-		return EXIT_FAILURE;
-	}
+		std::vector<Type_ID> ids;
+		ids.reserve(this->depency_batch.size());
 
-	T *database_get_by_privateID( Type_ID id)
-	{
-#ifdef _FLOVER_
-		if(this->flover->sql_database != nullptr)
+		for(const Depency_Request &request : this->depency_batch)
 		{
-			if(this->flover->sql_database->connected)
-			{
-				if(id != 0)
-				{
-					//return this->get_node_from_query(this->sql_database->make_query(this->query_create_get_by_id(id)));
+			ids.push_back(request.privateID);
+		}
 
-					std::string query = this->query_create_get_by_privateID(id);
+		std::sort(ids.begin(), ids.end());
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-					std::string data = this->flover->sql_database->make_query_get(query);
+		std::vector<T*> nodes(ids.size(), nullptr);
 
-					if(data.empty())
-					{
-						return nullptr;
-					}
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			auto at = std::lower_bound(ids.begin(), ids.end(), node->privateID);
 
-					T *node = this->create();
+			// The first one of the list, as with get_pointer_of_privateID()
+			if(at != ids.end() && *at == node->privateID && nodes[at - ids.begin()] == nullptr)
+			{
+				nodes[at - ids.begin()] = node;
 
-					node->xml_parse(Base64_get_string(data));
+				if(this->resident_budget != 0)
+				{
+					this->resident_hits++;
+					this->residency_reference(node);
 				}
 			}
 		}
-#endif
 
-		return nullptr;
-	}
+		std::vector<size_t> misses;
 
-	/*
-	  T* database_get_by_privateID( Type_ID privateID)
-	  {
-		 if(this->sql_database != nullptr)
-		 {
-			if(this->sql_database->connected)
+		for(size_t i = 0; i < ids.size(); i++)
+		{
+			if(nodes[i] == nullptr && ids[i] != 0)
 			{
-			  if(this->sql_database->make_query(this->query_create_get_by_privateID()) == EXIT_SUCCESS)
-			  {
-				 MYSQL_RES* result =mysql_store_result(this->sql_database->connection);
-				 if(result != nullptr)
-				 {
-					T *node = this->get_node_from_query(result);
-					mysql_free_result(result);
-					return node;
-				 }
-			  }
+				misses.push_back(i);
 			}
-		 }
 
-		 return nullptr;
-	  }
-	*/
+			// Loading the misses must not evict or delete the nodes found
+			else if(nodes[i] != nullptr)
+			{
+				nodes[i]->pins++;
+			}
+		}
 
-	int database_get_all()
-	{
-#ifdef _FLOVER_
-		if(this->flover->sql_database != nullptr)
+		size_t window = std::max<size_t>(this->prefetch_max, 1);
+
+		for(size_t begin = 0; begin < misses.size(); begin += window)
 		{
-			if(this->flover->sql_database->connected)
+			size_t end = std::min(begin + window, misses.size());
+
+			for(size_t i = begin; i < end; i++)
 			{
-				/*
-				if(this->sql_database->make_query(this->query_create_get_all()) == EXIT_SUCCESS)
+				Type_ID privateID = ids[misses[i]];
+
+				if(this->prefetch_reads.count(privateID) == 0 && this->cold_store.contains(privateID) == false &&
+						this->privateID_filter_may_exist(privateID))
 				{
-				  return this->nodes_from_query(mysql_store_result(this->sql_database->connection));
+					// One more, so that the node prefetches its depencies as after load_file()
+					this->prefetch_read(privateID, this->prefetch_depth + 1);
 				}
-				*/
 			}
-		}
-#endif
 
-		return EXIT_FAILURE;
-	}
+			for(size_t i = begin; i < end; i++)
+			{
+				T *node = this->privateID_load(ids[misses[i]]);
 
-	std::string query_create_get_by_privateID( Type_ID privateID)
-	{
-		if(privateID == 0)
+				if(node != nullptr)
+				{
+					node->pins++;
+					nodes[misses[i]] = node;
+				}
+			}
+		}
+
+		for(T *node : nodes)
 		{
-			return std::string();
+			if(node != nullptr)
+			{
+				node->sync(this->flover->sync_table);
+			}
 		}
 
-		std::string query;
-		query = "select * from "+ this->xml_node_path + " where privateID = " + base64Encode(variable_to_uchar<unsigned int>(privateID));
+		size_t resolved = 0;
 
-		return query;
-	}
+		for(const Depency_Request &request : this->depency_batch)
+		{
+			T *node = nodes[std::lower_bound(ids.begin(), ids.end(), request.privateID) - ids.begin()];
+			request.resolve(node);
 
+			if(request.owner_pins != nullptr)
+			{
+				(*request.owner_pins)--;
+			}
 
-	std::string query_create_delete_by_privateID( Type_ID id)
-	{
-		if(id != 0)
-		{
+			if(node != nullptr)
+			{
+				resolved++;
+			}
 		}
 
-		return std::string();
-	}
+		this->depency_batch.clear();
 
-	std::string query_create_save(T *node)
-	{
-		if(node != nullptr)
+		for(T *node : nodes)
 		{
+			if(node != nullptr)
+			{
+				node->pins--;
+			}
 		}
 
-		return std::string();
+		return resolved;
 	}
 
-	std::string query_create_update(T *node)
+	T *create(bool set_privateID = false)
 	{
-		if(node != nullptr)
+		T *new_node = new T(this->get_next_id());
+		this->add_to_last(new_node);
+		this->counter++;
+
+		if(set_privateID)
 		{
+			new_node->privateID = this->seek_next_ongoing_privateID();
 		}
 
-		return std::string();
-	}
+		give_pointers(new_node);
 
-	std::string query_create_get_all()
-	{
-		return std::string();
+		new_node->node_flags.bit_set(Node_Flags::Needed, true);
+		new_node->node_flags.bit_set(Node_Flags::To_Delete, false);
+
+		this->xml_set_node_settings(new_node);
+
+		return new_node;
 	}
-#endif
 
-	std::string get_node_name()
+	T *create_no_id()
 	{
-		return this->xml_node_name;
+		T *new_object = new T(0);
+		this->counter++;
+		give_pointers(new_object);
+		this->add_to_last(new_object);
+		return new_object;
 	}
 
-	std::string get_node_path()
+	virtual void give_pointers(T *node)
 	{
-		return this->xml_node_path;
+		if(node != nullptr)
+		{
+			return void();
+		}
 	}
 
-	int xml_files_read()
+	// Removes the node from the list without deleting it
+	void unlink(T *node)
 	{
-		if(this->flover->sync_table.delete_on_memory_present)
+		if(node->prev != nullptr)
 		{
-			this->delete_nodes();
+			node->prev->next = node->next;
 		}
 
-		this->all_files_read = true;
+		else
+		{
+			this->first = node->next;
+		}
 
-		std::string data_path =
-#ifdef _FLOVER_
-				this->flover->options->get_xml_path(this->flover->sync_table.sql_push) +
-#endif
-				this->get_node_path();
-#ifndef ANDROID
+		if(node->next != nullptr)
+		{
+			node->next->prev = node->prev;
+		}
 
-		if(file_exits(data_path) == EXIT_FAILURE)
+		else
 		{
-			return EXIT_FAILURE;
+			this->last = node->prev;
 		}
 
-#ifdef __WASM__
+		node->prev = nullptr;
+		node->next = nullptr;
+		this->counter--;
 
-		for(auto &p : std::__fs::filesystem::directory_iterator(data_path))
-#else
-		for(auto &p : std::filesystem::directory_iterator(data_path))
-#endif
+		if(this->current == node)
 		{
-			std::string name;
-			name = p.path().string();
-
-			if(name.find(std::string(".xml")) !=std::string::npos)
-			{
-				std::string buffer = file_read_text(this->flover->sync_table, name);
+			this->current = nullptr;
+			this->current_changed = true;
+		}
 
-				if(buffer.empty() == false)
-				{
-					this->xml_node_parse(buffer);
-				}
-			}
+		if(this->current_prev == node)
+		{
+			this->current_prev = nullptr;
 		}
 
-		return EXIT_SUCCESS;
-#else
-		AAssetDir *dir = AAssetManager_openDir(this->flover->options->engine->app->activity->assetManager, data_path.c_str());
+		this->indexes_remove(node);
+	}
 
-		if(dir != nullptr)
-		{
-			std::string name;
-			 char *c_name;
-			c_name = AAssetDir_getNextFileName(dir);
+	/*
+	 * Pinned nodes are kept, when keep_pinned is set, and marked to be
+	 * deleted by delete_unneeded() once the depency batches pinning them
+	 * are resolved.
+	 */
+	int delete_nodes(bool keep_pinned = true)
+	{
+		T *temp = nullptr;
+		T *temp_delete = nullptr;
+		temp = this->first;
 
-			while(c_name != nullptr)
+		if(temp != nullptr)
+		{
+			while(temp != nullptr)
 			{
-				name = c_name;
-				std::string file_path = data_path + XML_STRING_SLASH + name;
+				temp_delete = temp;
+				temp = temp->next;
 
-				this->xml_node_parse(file_read_text(this->flover->sync_table, file_path));
+				if(keep_pinned && temp_delete->pins != 0)
+				{
+					temp_delete->node_flags.bit_set(Node_Flags::Delete_Node, true);
+					continue;
+				}
 
+#ifdef _FLOVER_
+				temp_delete->unsync(this->flover->sync_table);
+#endif
 
-				name.clear();
-				c_name = AAssetDir_getNextFileName(dir);
+				this->unlink(temp_delete);
+				delete temp_delete;
 			}
 
-			return EXIT_SUCCESS;
-		}
+			this->all_files_read = false;
+			this->clear_current_values();
+#ifdef _NODE_INFO_COMPACT
+			this->string_pool.collect();
+#endif
+
+			return EXIT_SUCCESS;
+		}
+
+
+		return EXIT_FAILURE;
+	}
+
+	int delete_node_by_privateID(Type_ID id,  bool delete_file = false)
+	{
+		return this->del(this->_get_pointer_of_privateID(id), delete_file);
+	}
+
+	int delete_node_by_id( Type_ID id,  bool delete_file = false)
+	{
+		return this->del(this->get_pointer_of_id(id), delete_file);
+	}
+
+	void add_to_last(T *node)
+	{
+		if(this->first == nullptr && this->last == nullptr)
+		{
+			this->first = node;
+			this->last = node;
+			node->prev = nullptr;
+			node->next = nullptr;
+		}
+
+		else
+		{
+			node->prev = this->last;
+			this->last->next = node;
+			this->last = this->last->next;
+			this->last->next = nullptr;
+		}
+
+		this->indexes_add(node);
+	}
+
+	/*
+	 * Called when a node is linked to or unlinked from the list of the
+	 * manager, for the indexes of the nodes.
+	 */
+	virtual void index_add(T *node)
+	{
+		if(node != nullptr)
+		{
+			return void();
+		}
+	}
+
+	virtual void index_remove(T *node)
+	{
+		if(node != nullptr)
+		{
+			return void();
+		}
+	}
+
+	/*
+	 * Optional index of the names, for the lookups by name. It is kept up
+	 * to date on create, delete and rename(), names set straight to
+	 * Node_Info need name_index_update(). Loads the names of the nodes.
+	 */
+	void name_index_enable(bool enable = true)
+	{
+		this->name_index.clear();
+		this->name_index_enabled = enable;
+
+		if(enable)
+		{
+			for(T *node = this->first; node != nullptr; node = node->next)
+			{
+				this->name_index.add(node, *node->get_name());
+			}
+		}
+	}
+
+	bool name_index_is_enabled()
+	{
+		return this->name_index_enabled;
+	}
+
+	// After the name of a node of this manager has been changed
+	void name_index_update(T *node)
+	{
+		if(this->name_index_enabled && node != nullptr)
+		{
+			this->name_index.add(node, *node->get_name());
+		}
+	}
+
+	void rename(T *node, std::string_view name)
+	{
+		node->set_name(name);
+		this->name_index_update(node);
+	}
+
+	// One of the nodes with the name, nullptr if none
+	T *get_pointer_of_name(std::string_view name)
+	{
+		if(this->name_index_enabled)
+		{
+			return this->name_index.find(name);
+		}
+
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			if(*node->get_name() == name)
+			{
+				return node;
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::vector<T*> get_pointers_of_name(std::string_view name)
+	{
+		std::vector<T*> nodes;
+
+		if(this->name_index_enabled)
+		{
+			this->name_index.find_all(name, nodes);
+			return nodes;
+		}
+
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			if(*node->get_name() == name)
+			{
+				nodes.push_back(node);
+			}
+		}
+
+		return nodes;
+	}
+
+	/*
+	 * Nodes whose name starts with prefix, at most max_count when it is
+	 * not 0. With the index they are in the order of the names, otherwise
+	 * in the order of the list.
+	 */
+	std::vector<T*> get_pointers_of_name_prefix(std::string_view prefix, size_t max_count = 0)
+	{
+		std::vector<T*> nodes;
+
+		if(this->name_index_enabled)
+		{
+			this->name_index.find_prefix(prefix, nodes, max_count);
+			return nodes;
+		}
+
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			if(max_count != 0 && nodes.size() == max_count)
+			{
+				break;
+			}
+
+			if(std::string_view(*node->get_name()).substr(0, prefix.size()) == prefix)
+			{
+				nodes.push_back(node);
+			}
+		}
+
+		return nodes;
+	}
+
+	/*
+	 * Makes a new snapshot of the nodes and publishes it for
+	 * snapshot_latest(). Has to be called from the thread, which changes
+	 * the manager. Only nodes, which have been created or set_modified()
+	 * after the earlier snapshots, are copied, the others are shared.
+	 * Changes made without set_modified() are not seen, see Node::set_modified().
+	 */
+	std::shared_ptr<const Manager_Snapshot<T>> snapshot()
+	{
+		std::shared_ptr<Manager_Snapshot<T>> view = std::make_shared<Manager_Snapshot<T>>();
+		std::unordered_map<const T*, Snapshot_Version> versions;
+
+		view->version = ++this->snapshot_counter;
+		view->nodes.reserve(this->counter);
+		versions.reserve(this->counter);
+
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			std::shared_ptr<const T> copy;
+			auto found = this->snapshot_versions.find(node);
+
+			if(found != this->snapshot_versions.end() && found->second.stamp == node->get_modified_stamp())
+			{
+				copy = found->second.node.lock();
+			}
+
+			if(copy == nullptr)
+			{
+#ifdef _XML_SUPPORT
+				node->xml_fault_in(Node_Fields::All);
+#endif
+				T *clone = node->snapshot_clone();
+				clone->prev = nullptr;
+				clone->next = nullptr;
+				clone->snapshot_detach();
+
+				copy = std::shared_ptr<const T>(clone);
+			}
+
+			versions[node] = Snapshot_Version{node->get_modified_stamp(), copy};
+			view->privateIDs.emplace_back(node->privateID, view->nodes.size());
+			view->nodes.push_back(std::move(copy));
+		}
+
+		std::sort(view->privateIDs.begin(), view->privateIDs.end());
+
+		this->snapshot_versions.swap(versions);
+		std::shared_ptr<const Manager_Snapshot<T>> result = view;
+		std::atomic_store(&this->snapshot_last, result);
+
+		return result;
+	}
+
+	// Latest snapshot for the reader threads, nullptr before the first snapshot()
+	std::shared_ptr<const Manager_Snapshot<T>> snapshot_latest()
+	{
+		return std::atomic_load(&this->snapshot_last);
+	}
+
+	/*
+	 * Memory budget in bytes for the nodes, which get_pointer_of_privateID()
+	 * loads on demand, 0 disables it. Over the budget, such nodes are
+	 * evicted in CLOCK order, skipping the current and the Needed ones.
+	 * The loaded nodes are not Needed, set_needed(true) keeps a node in
+	 * memory. Nodes changed since loading, by their modified stamp, are
+	 * written to their files before they are evicted, see
+	 * Node::set_modified(). Nodes are serialized only for the cold store.
+	 */
+	void residency_budget_set(size_t budget)
+	{
+		if(budget == 0)
+		{
+			this->resident_ring.clear();
+			this->resident_positions.clear();
+			this->resident_memory = 0;
+			this->resident_hand = 0;
+			this->resident_removed = 0;
+		}
+
+		this->resident_budget = budget;
+
+		if(budget != 0)
+		{
+			this->residency_evict(nullptr);
+		}
+	}
+
+	size_t residency_budget_get()
+	{
+		return this->resident_budget;
+	}
+
+	// Bytes of the nodes under the budget, by their last measured sizes
+	size_t residency_memory_get()
+	{
+		return this->resident_memory;
+	}
+
+	/*
+	 * Budget in bytes for the compressed copies of the evicted nodes,
+	 * 0 disables them. get_pointer_of_privateID() parses a node from its
+	 * copy before reading the file. The oldest copies are dropped first.
+	 */
+	void cold_store_budget_set(size_t budget)
+	{
+		this->cold_store.set_budget(budget);
+	}
+
+	size_t cold_store_budget_get()
+	{
+		return this->cold_store.get_budget();
+	}
+
+	// Counts since the construction of the manager, for tuning the budgets
+	struct Residency_Stats
+	{
+		size_t hot_count;
+		size_t hot_memory;
+		size_t cold_count;
+		size_t cold_memory;
+		size_t cold_size;
+
+		uint64_t hot_hits;
+		uint64_t cold_hits;
+		uint64_t disk_loads;
+		uint64_t evictions;
+		uint64_t cold_drops;
+	};
+
+	Residency_Stats residency_stats_get()
+	{
+		Residency_Stats stats;
+		stats.hot_count = this->resident_positions.size();
+		stats.hot_memory = this->resident_memory;
+		stats.cold_count = this->cold_store.get_count();
+		stats.cold_memory = this->cold_store.get_memory();
+		stats.cold_size = this->cold_store.get_size();
+		stats.hot_hits = this->resident_hits;
+		stats.cold_hits = this->cold_hits;
+		stats.disk_loads = this->resident_loads;
+		stats.evictions = this->resident_evictions;
+		stats.cold_drops = this->cold_store.get_drops();
+
+		return stats;
+	}
+
+	// Measures the node again, after it has grown or shrunk much
+	void residency_update(T *node)
+	{
+		auto found = this->resident_positions.find(node);
+
+		if(found == this->resident_positions.end())
+		{
+			return void();
+		}
+
+		Resident &resident = this->resident_ring[found->second];
+		this->resident_memory -= resident.size;
+		resident.size = node->memory_size();
+		this->resident_memory += resident.size;
+
+		this->residency_evict(node);
+	}
+
+	/*
+	 * Optional full text index of the info and memo of the nodes, stored
+	 * next to the node files. It is updated when node files are written
+	 * or deleted, nodes written while it is disabled are missing from it
+	 * until text_index_rebuild().
+	 */
+	void text_index_enable(bool enable = true)
+	{
+		this->text_index_enabled = enable;
+	}
+
+	bool text_index_is_enabled()
+	{
+		return this->text_index_enabled;
+	}
+
+	std::string text_index_path()
+	{
+		return this->xml_directory_path() + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + "text_index.idx";
+	}
+
+	// Read once from text_index_path(), when first needed
+	Text_Index *text_index_get()
+	{
+		this->xml_path_check();
+
+		if(this->text_index_checked == false)
+		{
+			this->text_index.file_read(this->text_index_path());
+			this->text_index_checked = true;
+		}
+
+		return &this->text_index;
+	}
+
+	// privateIDs of the nodes having all of the words of query, without loading the nodes
+	std::vector<Type_ID> text_search(std::string_view query)
+	{
+		return this->text_index_get()->search(query);
+	}
+
+	// Indexes all of the nodes again, reads the nodes not in memory
+	int text_index_rebuild()
+	{
+		this->xml_read_all_non_in_memory();
+		this->text_index_get()->clear();
+
+		for(T *node = this->first; node != nullptr; node = node->next)
+		{
+			this->text_index_node_update(node);
+		}
+
+		if(directory_exits_create(this->xml_directory_path()) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		return this->text_index.file_write(this->text_index_path());
+	}
+
+	/*
+	 * Moves the node from the source manager to the end of this one.
+	 * The node is relinked, not reallocated or copied, so pointers to it
+	 * stay valid. It has to be a node of source, that is not searched for.
+	 * The id is renewed, privateIDs are not checked for duplicates.
+	 */
+	int splice(T *node, Manager<T> *source)
+	{
+		if(node == nullptr || source == nullptr || source == this)
+		{
+			return EXIT_FAILURE;
+		}
+
+		source->unlink(node);
+		this->add_to_last(node);
+		this->counter++;
+		this->splice_node_settings(node);
+
+		return EXIT_SUCCESS;
+	}
+
+	/*
+	 * Moves all of the nodes of source to the end of this manager.
+	 * The lists are joined at once, only the settings and index entries
+	 * of the nodes are updated one by one.
+	 */
+	int splice_all(Manager<T> *source)
+	{
+		if(source == nullptr || source == this)
+		{
+			return EXIT_FAILURE;
+		}
+
+		T *node = source->first;
+
+		if(node == nullptr)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		if(this->last == nullptr)
+		{
+			this->first = source->first;
+		}
+
+		else
+		{
+			this->last->next = source->first;
+			source->first->prev = this->last;
+		}
+
+		this->last = source->last;
+		this->counter += source->counter;
+
+		while(node != nullptr)
+		{
+			source->indexes_remove(node);
+			this->indexes_add(node);
+			this->splice_node_settings(node);
+
+			node = node->next;
+		}
+
+		source->clear_pointers();
+		source->clear_current_values();
+		source->counter = 0;
+
+		return EXIT_SUCCESS;
+	}
+
+	virtual void set_nodes_to_unneeded(bool value = false)
+	{
+		T *temp = this->first;
+
+		while(temp != nullptr)
+		{
+			temp->set_needed(value);
+			temp = temp->next;
+		}
+	}
+
+	virtual void delete_unneeded()
+	{
+		T *temp = this->first;
+
+		if(temp != nullptr)
+		{
+			while(temp != nullptr)
+			{
+				// Deleted by a later call, after its depency batch is resolved
+				if(temp->pins != 0)
+				{
+					temp = temp->next;
+				}
+
+				else if(temp->node_flags.bit_get(Node_Flags::Needed) == false ||
+						temp->node_flags.bit_get(Node_Flags::Delete_Node))
+				{
+					T *temp_delete = temp;
+					temp->runtime_clear();
+					temp = temp->next;
+
+					this->_del(temp_delete);
+				}
+
+				else
+				{
+					temp->delete_unneeded_content();
+					temp = temp->next;
+				}
+			}
+
+			this->all_files_read = false;
+		}
+	}
+
+	virtual int unsync_manager(Sync_Table &table)
+	{
+		T *node = this->first;
+
+		if(node != nullptr)
+		{
+			while(node != nullptr)
+			{
+				node->unsync(table);
+				node = node->next;
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	virtual int unsync_manager()
+	{
+		T *node = this->first;
+
+		if(node != nullptr)
+		{
+			while(node != nullptr)
+			{
+				node->unsync(this->flover->sync_table);
+				node = node->next;
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	int sync_all(Sync_Table &table)
+	{
+		T *node = this->first;
+
+		if(node != nullptr)
+		{
+			while(node != nullptr)
+			{
+				node->sync(table);
+				node = node->next;
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	int sync_all()
+	{
+		T *node = this->first;
+
+		if(node != nullptr)
+		{
+			while(node != nullptr)
+			{
+				node->sync(this->flover->sync_table);
+				node = node->next;
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	int node_exists(T *node)
+	{
+		if(node != nullptr)
+		{
+			T *temp = this->first;
+
+			while(temp != nullptr)
+			{
+				if(node == temp)
+				{
+					return EXIT_SUCCESS;
+				}
+
+				temp = temp->next;
+			}
+		}
+
+		return EXIT_FAILURE;
+	}
+
+#ifdef _SQL_DATABASE
+	int database_delete(T *node)
+	{
+#ifdef _FLOVER_
+		if(this->flover->sql_database != nullptr)
+		{
+			if(this->flover->sql_database->connected)
+			{
+				if(this->flover->sql_database->make_query(this->query_create_delete_by_id(node->sqlID)) == EXIT_SUCCESS)
+				{
+					return EXIT_SUCCESS;
+				}
+			}
+		}
+#endif
+		return EXIT_FAILURE;
+	}
+
+	int database_delete_by_privateID( Type_ID privateID)
+	{
+		if(this->sql_database != nullptr)
+		{
+			if(this->sql_database->connected)
+			{
+				return this->sql_database->make_query(this->query_create_delete_by_privateID(privateID));
+			}
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	int database_save(T *node)
+	{
+#ifdef _FLOVER_
+		if(this->flover->sql_database != nullptr)
+		{
+			if(this->flover->sql_database->connected)
+			{
+				if(this->flover->sql_database->make_query(this->query_create_save(node)) == EXIT_SUCCESS)
+				{
+					return EXIT_SUCCESS;
+				}
+			}
+		}
+#endif
+
+		return EXIT_FAILURE;
+	}
+
+	int database_update(T *node)
+	{
+		if(this->sql_database != nullptr)
+		{
+			if(this->sql_database->connected)
+			{
+				if(this->sql_database->make_query(this->query_create_update(node)) == EXIT_SUCCESS)
+				{
+					return EXIT_SUCCESS;
+				}
+			}
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	T *database_get_by_privateID( Type_ID id)
+	{
+#ifdef _FLOVER_
+		if(this->flover->sql_database != nullptr)
+		{
+			if(this->flover->sql_database->connected)
+			{
+				if(id != 0)
+				{
+					//return this->get_node_from_query(this->sql_database->make_query(this->query_create_get_by_id(id)));
+
+					std::string query = this->query_create_get_by_privateID(id);
+
+					std::string data = this->flover->sql_database->make_query_get(query);
+
+					if(data.empty())
+					{
+						return nullptr;
+					}
+
+					T *node = this->create();
+
+					node->xml_parse(Base64_get_string(data));
+				}
+			}
+		}
+#endif
+
+		return nullptr;
+	}
+
+	// privateIDs of the rows, make_query_get() gives them one per line
+	int database_get_privateIDs(std::vector<Type_ID> *ids)
+	{
+#ifdef _FLOVER_
+		if(this->flover->sql_database != nullptr)
+		{
+			if(this->flover->sql_database->connected)
+			{
+				std::string data = this->flover->sql_database->make_query_get(this->query_create_get_privateIDs());
+				size_t position = 0;
+
+				while(position < data.size())
+				{
+					size_t end = data.find('\n', position);
+
+					if(end == std::string::npos)
+					{
+						end = data.size();
+					}
+
+					std::vector<unsigned char> raw = base64Decode(data.substr(position, end - position));
+
+					if(raw.size() == sizeof(unsigned int))
+					{
+						ids->push_back(Type_ID(uchar_to_variable<unsigned int>(raw)));
+					}
+
+					position = end + 1;
+				}
+
+				return EXIT_SUCCESS;
+			}
+		}
+#else
+		if(ids != nullptr)
+		{
+		}
+#endif
+
+		return EXIT_FAILURE;
+	}
+
+	/*
+	  T* database_get_by_privateID( Type_ID privateID)
+	  {
+		 if(this->sql_database != nullptr)
+		 {
+			if(this->sql_database->connected)
+			{
+			  if(this->sql_database->make_query(this->query_create_get_by_privateID()) == EXIT_SUCCESS)
+			  {
+				 MYSQL_RES* result =mysql_store_result(this->sql_database->connection);
+				 if(result != nullptr)
+				 {
+					T *node = this->get_node_from_query(result);
+					mysql_free_result(result);
+					return node;
+				 }
+			  }
+			}
+		 }
+
+		 return nullptr;
+	  }
+	*/
+
+	int database_get_all()
+	{
+#ifdef _FLOVER_
+		if(this->flover->sql_database != nullptr)
+		{
+			if(this->flover->sql_database->connected)
+			{
+				/*
+				if(this->sql_database->make_query(this->query_create_get_all()) == EXIT_SUCCESS)
+				{
+				  return this->nodes_from_query(mysql_store_result(this->sql_database->connection));
+				}
+				*/
+			}
+		}
+#endif
+
+		return EXIT_FAILURE;
+	}
+
+	std::string query_create_get_by_privateID( Type_ID privateID)
+	{
+		if(privateID == 0)
+		{
+			return std::string();
+		}
+
+		std::string query;
+		query = "select * from "+ this->xml_node_path + " where privateID = " + base64Encode(variable_to_uchar<unsigned int>(privateID));
+
+		return query;
+	}
+
+
+	std::string query_create_get_privateIDs()
+	{
+		return "select privateID from " + this->xml_node_path;
+	}
+
+	std::string query_create_delete_by_privateID( Type_ID id)
+	{
+		if(id != 0)
+		{
+		}
+
+		return std::string();
+	}
+
+	std::string query_create_save(T *node)
+	{
+		if(node != nullptr)
+		{
+		}
+
+		return std::string();
+	}
+
+	std::string query_create_update(T *node)
+	{
+		if(node != nullptr)
+		{
+		}
+
+		return std::string();
+	}
+
+	std::string query_create_get_all()
+	{
+		return std::string();
+	}
+#endif
+
+	std::string get_node_name()
+	{
+		return this->xml_node_name;
+	}
+
+	std::string get_node_path()
+	{
+		return this->xml_node_path;
+	}
+
+	void set_node_name(std::string name)
+	{
+		this->xml_node_name = std::move(name);
+		this->xml_path_reset();
+	}
+
+	void set_node_path(std::string path)
+	{
+		this->xml_node_path = std::move(path);
+		this->xml_path_reset();
+	}
+
+	int xml_files_read()
+	{
+		if(this->flover->sync_table.delete_on_memory_present)
+		{
+			this->delete_nodes();
+		}
+
+		this->all_files_read = true;
+
+		std::string data_path =
+#ifdef _FLOVER_
+				this->flover->options->get_xml_path(this->flover->sync_table.sql_push) +
+#endif
+				this->get_node_path();
+#ifndef ANDROID
+
+		if(file_exits(data_path) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		Directory_Index *index = data_path == this->xml_directory_path() ? this->directory_index_get() : nullptr;
+
+		if(index != nullptr)
+		{
+			for(const Directory_Index_Entry &entry : index->get_entries())
+			{
+				std::string buffer = file_read_text(this->flover->sync_table, data_path + XML_STRING_SLASH + entry.name);
+
+				if(buffer.empty() == false)
+				{
+					this->xml_node_parse(buffer);
+				}
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+#ifdef __WASM__
+
+		for(auto &p : std::__fs::filesystem::directory_iterator(data_path))
+#else
+		for(auto &p : std::filesystem::directory_iterator(data_path))
+#endif
+		{
+			std::string name;
+			name = p.path().string();
+
+			if(name.find(std::string(".xml")) !=std::string::npos)
+			{
+				std::string buffer = file_read_text(this->flover->sync_table, name);
+
+				if(buffer.empty() == false)
+				{
+					this->xml_node_parse(buffer);
+				}
+			}
+		}
+
+		return EXIT_SUCCESS;
+#else
+		AAssetDir *dir = AAssetManager_openDir(this->flover->options->engine->app->activity->assetManager, data_path.c_str());
+
+		if(dir != nullptr)
+		{
+			std::string name;
+			 char *c_name;
+			c_name = AAssetDir_getNextFileName(dir);
+
+			while(c_name != nullptr)
+			{
+				name = c_name;
+				std::string file_path = data_path + XML_STRING_SLASH + name;
+
+				this->xml_node_parse(file_read_text(this->flover->sync_table, file_path));
+
+
+				name.clear();
+				c_name = AAssetDir_getNextFileName(dir);
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+#endif
+	}
+
+	// data_final reads the listing of the Data_Final path
+	int xml_file_listing_read(bool data_final = false)
+	{
+		std::string data_path = this->xml_directory_path(data_final);
+		/*
+			 if(file_exits(data_path, this->flover->options) == EXIT_FAILURE)
+			 {
+				return EXIT_FAILURE;
+			 }
+		*/
+		std::string path = data_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE XML_STRING_LISTING XML_STRING_FILENAME_EXTENSION_XML;
+
+#if defined(_ZLIB) || defined(_ZSTD)
+		Listing_Stream_Reader reader;
+
+		if(reader.open(this->xml_listing_stream_path(data_final)) == EXIT_SUCCESS)
+		{
+			return this->xml_listing_stream_read(reader);
+		}
+#endif
+
+		return this->xml_listing_read(file_read_text(this->flover->sync_table, path));
+	}
+
+#if defined(_ZLIB) || defined(_ZSTD)
+	/*
+	 * Listing as one compressed stream, see Listing_Stream.h. It is read
+	 * by xml_file_listing_read() instead of the xml listing, when it exists.
+	 * xml_listing_file_write() deletes it, as it would be older then.
+	 */
+	std::string xml_listing_stream_path(bool data_final = false)
+	{
+		return this->xml_directory_path(data_final) + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE XML_STRING_LISTING ".xmlz";
+	}
+
+	int xml_listing_stream_write()
+	{
+		XML_Options_Table options = this->flover->xml_options;
+		options.compress_node = false;
+
+		if(directory_exits_create(this->xml_directory_path(options.target_dataFinal)) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		Listing_Stream_Writer writer;
+
+		if(writer.open(this->xml_listing_stream_path(options.target_dataFinal)) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		tinyxml2::XMLPrinter printer;
+		this->xml_write_manager_values(&printer);
+
+		if(printer.CStrSize() > 1)
+		{
+			writer.append(std::string_view(printer.CStr(), printer.CStrSize() - 1), 0);
+		}
+
+		T *node = this->first;
+
+		while(node != nullptr)
+		{
+			printer.ClearBuffer();
+			this->xml_set_node_settings(node);
+			node->xml_create(&printer, options);
+
+			if(writer.append(std::string_view(printer.CStr(), printer.CStrSize() - 1), node->privateID) == EXIT_FAILURE)
+			{
+				writer.close();
+				return EXIT_FAILURE;
+			}
+
+			node = node->next;
+		}
+
+		return writer.close();
+	}
+
+	// Frames are decompressed one at a time, so only one frame is in memory
+	int xml_listing_stream_read(Listing_Stream_Reader &reader)
+	{
+		std::string xml;
+
+		for(size_t i = 0; i < reader.get_frame_count(); i++)
+		{
+			if(reader.frame_read(i, xml) == EXIT_FAILURE)
+			{
+				return EXIT_FAILURE;
+			}
+
+			tinyxml2::XMLDocument document;
+			document.Parse(xml.c_str(), xml.size());
+			tinyxml2::XMLElement *element = document.FirstChildElement();
+
+			while(element != nullptr)
+			{
+				this->xml_listing_read_element(element);
+				element = element->NextSiblingElement();
+			}
+		}
+
+		if(this->first != nullptr)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	// Reads only the frame of the node from the listing stream
+	T *xml_listing_stream_read_node(Type_ID privateID)
+	{
+		Listing_Stream_Reader reader;
+		std::string xml;
+
+		if(reader.open(this->xml_listing_stream_path()) == EXIT_FAILURE || reader.find(privateID, xml) == EXIT_FAILURE)
+		{
+			return nullptr;
+		}
+
+		return this->xml_node_parse(xml);
+	}
+#endif
+
+	int xml_files_write()
+	{
+#ifdef _SQL_DATABASE
+#ifdef _FLOVER_
+		if(this->flover->options->database_target == Data_Location::SQL)
+		{
+			if(this->flover->sql_database == nullptr)
+			{
+				return EXIT_FAILURE;
+			}
+		}
+#endif
+#endif
+
+		T *node = this->first;
+
+		if(node != nullptr)
+		{
+#ifdef _FLOVER_
+			if(this->flover->options->database_target != Data_Location::SQL)
+#else
+			if(this->flover->sync_table.target_sql)
+#endif
+			{
+#ifdef _FLOVER_
+				bool data_final = this->flover->xml_options.target_dataFinal;
+#else
+				bool data_final = false;
+#endif
+
+				if(directory_exits_create(this->xml_directory_path(data_final)) == EXIT_FAILURE)
+				{
+					return EXIT_FAILURE;
+				}
+
+				// The stored index is read first, else writing it would drop the nodes not in memory
+				if(this->text_index_enabled)
+				{
+					this->text_index_get();
+				}
+
+				if(data_final == false)
+				{
+					this->directory_index_writing();
+				}
+
+				do
+				{
+					if(node->privateID != 0)
+					{
+						tinyxml2::XMLPrinter printer;
+						node->xml_get(&printer, this->flover->xml_options, this->xml_compress_dictionary());
+
+						file_write_text(this->xml_file_path(node, data_final), printer.CStr());
+						this->privateID_filter_add(node->privateID);
+
+						if(data_final == false)
+						{
+							this->directory_index_written(node, std::string_view(printer.CStr(), printer.CStrSize() - 1));
+						}
+
+						if(this->text_index_enabled)
+						{
+							this->text_index_node_update(node);
+						}
+
+						this->residency_clean(node);
+					}
+
+					node = node->next;
+				}
+				while(node != nullptr);
+
+				if(this->text_index_enabled)
+				{
+					this->text_index.file_write(this->text_index_path());
+				}
+
+				this->directory_index_save();
+			}
+
+#ifdef _SQL_DATABASE
+
+			else
+			{
+
+				do
+				{
+					if(node->privateID != 0 && this->database_save(node) == EXIT_SUCCESS)
+					{
+						this->privateID_filter_add(node->privateID);
+					}
+
+					node = node->next;
+				}
+				while(node != nullptr);
+			}
+
+#endif
+
+			EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	void create_new_privateIDs(bool write_xml_files)
+	{
+		Type_ID temp_id = 1;
+
+		this->cold_store.clear();
+		this->privateID_filter_valid = false;
+
+		if(this->text_index_enabled)
+		{
+			this->text_index_get()->clear();
+		}
+
+		T *node = this->first;
+
+		while(node != nullptr)
+		{
+			node->privateID = temp_id;
+			node->set_modified();
+			temp_id++;
+
+			if(this->text_index_enabled)
+			{
+				this->text_index_node_update(node);
+			}
+
+			node = node->next;
+		}
+
+		// The stored index has the old privateIDs
+		if(this->text_index_enabled && directory_exits_create(this->xml_directory_path()) == EXIT_SUCCESS)
+		{
+			this->text_index.file_write(this->text_index_path());
+		}
+
+		if(write_xml_files)
+		{
+			this->xml_files_write();
+		}
+	}
+
+	int xml_file_write_by_pointer(T *node)
+	{
+		if(this->node_exists(node) == EXIT_SUCCESS)
+		{
+			return this->xml_file_write_node(node);
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	// Same without searching the list, node has to be of this manager
+	int xml_file_write_node(T *node)
+	{
+#ifdef _FLOVER_
+		if(directory_exits_create(this->xml_directory_path()) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+#endif
+		std::string path = this->xml_file_path(node);
+		std::string xml_file;
+
+		tinyxml2::XMLPrinter printer;
+		node->xml_get(&printer, this->flover->xml_options, this->xml_compress_dictionary());
+
+		xml_file = printer.CStr();
+
+		this->directory_index_writing();
+
+		if(file_write_text(path, xml_file) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		this->privateID_filter_add(node->privateID);
+		this->directory_index_written(node, xml_file);
+		this->directory_index_journal();
+
+		if(this->text_index_enabled)
+		{
+			this->text_index_node_update(node);
+			this->text_index.file_update(this->text_index_path());
+		}
+
+		this->residency_clean(node);
+
+		return EXIT_SUCCESS;
+	}
+
+	int xml_listing_file_write()
+	{
+#ifdef _FLOVER_
+		if(this->flover == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
+#endif
+
+		std::string data_path;
+#ifdef _FLOVER_
+		if(this->flover->xml_options.target_dataFinal)
+		{
+			data_path = this->flover->options->get_dataFinal_path() + this->xml_node_path;
+		}
+
+		else
+		{
+			data_path = this->flover->options->get_xml_path() + this->xml_node_path;
+		}
+#else
+		data_path = this->xml_node_path;
+#endif
+
+		if(directory_exits_create(data_path) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		std::string path = data_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE XML_STRING_LISTING XML_STRING_FILENAME_EXTENSION_XML;
+		std::string xml_file;
+		tinyxml2::XMLPrinter printer;
+		this->xml_listing_write(&printer);
+		xml_file = printer.CStr();
+
+		if(file_write_text(path, xml_file) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+#if defined(_ZLIB) || defined(_ZSTD)
+#ifdef _FLOVER_
+		std::remove(this->xml_listing_stream_path(this->flover->xml_options.target_dataFinal).c_str());
+#else
+		std::remove(this->xml_listing_stream_path().c_str());
+#endif
+#endif
+
+		return EXIT_SUCCESS;
+	}
+
+	int xml_file_delete_by_privateID(Type_ID privateID)
+	{
+		if(privateID != 0)
+		{
+			if(this->text_index_enabled)
+			{
+				this->text_index_get()->remove(privateID);
+				this->text_index.file_update(this->text_index_path());
+			}
+
+			this->cold_store.remove(privateID);
+			this->prefetch_reads.erase(privateID);
+
+			this->directory_index_writing();
+
+			this->xml_file_path(privateID, this->xml_path_buffer);
+			int status = std::remove(this->xml_path_buffer.c_str());
+
+			if(this->directory_index_enabled && this->directory_index_checked)
+			{
+				this->directory_index.file_removed(this->xml_directory_path(), privateID);
+				this->directory_index_journal();
+			}
+
+			return status;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	// Node of an other manager, which has been moved to this one
+	void splice_node_settings(T *node)
+	{
+		node->id = this->get_next_id();
+		this->give_pointers(node);
+		this->xml_set_node_settings(node);
+
+#ifdef _NODE_INFO_COMPACT
+		// The strings may be of the pool of the other manager
+		node->info.set_name(node->info.name);
+		node->info.set_info(node->info.info);
+		node->info.set_memo(node->info.memo);
+#endif
+		this->name_index_update(node);
+	}
+
+	void xml_set_node_settings(T *node)
+	{
+#ifdef _NODE_INFO_COMPACT
+		node->info.pool = &this->string_pool;
+
+		if(this->xml_node_tag != this->xml_node_name)
+		{
+			this->xml_node_tag = this->string_pool.intern(this->xml_node_name);
+		}
+
+		node->xml_set_node_infos(this->xml_node_tag);
+#else
+		node->xml_set_node_infos(this->xml_node_name);
+#endif
+	}
+
+	/*
+	 * Directory of the node files, data_final selects the Data_Final path
+	 * instead of the xml path. Computed again after xml_path_reset().
+	 */
+	const std::string &xml_directory_path(bool data_final = false)
+	{
+		this->xml_path_check();
+
+		return this->xml_directory[data_final];
+	}
+
+	// Full path of the node file "<directory>/<node name>_<privateID>.xml"
+	std::string xml_file_path(Type_ID privateID, bool data_final = false)
+	{
+		char encoded[XML_ENCODED_PRIVATEID_SIZE];
+		unsigned char raw[sizeof(Type_ID)];
+		std::memcpy(raw, &privateID, sizeof(Type_ID));
+		size_t size = base64Encode(raw, sizeof(Type_ID), encoded);
+
+		return this->xml_file_path(encoded, size, data_final);
+	}
+
+	std::string xml_file_path(T *node, bool data_final = false)
+	{
+		const char *encoded = node->get_encoded_privateID();
+
+		return this->xml_file_path(encoded, std::strlen(encoded), data_final);
+	}
+
+	// Formats into path, a path reused by the caller is not allocated again
+	void xml_file_path(Type_ID privateID, std::string &path, bool data_final = false)
+	{
+		char encoded[XML_ENCODED_PRIVATEID_SIZE];
+		unsigned char raw[sizeof(Type_ID)];
+		std::memcpy(raw, &privateID, sizeof(Type_ID));
+		size_t size = base64Encode(raw, sizeof(Type_ID), encoded);
+
+		this->xml_file_path_format(encoded, size, data_final, path);
+	}
+
+	/*
+	 * Forgets the paths and everything read from them. set_node_name() and
+	 * set_node_path() do it, it has to be called after the paths of the
+	 * options change or derived classes assign xml_node_name or xml_node_path.
+	 */
+	void xml_path_reset()
+	{
+		this->xml_path_valid = false;
+		this->text_index_checked = false;
+		this->directory_index_checked = false;
+		this->cold_store.clear();
+		this->prefetch_reads.clear();
+		this->privateID_filter_valid = false;
+#ifdef _ZSTD
+		this->xml_dictionary_checked = false;
+#endif
+	}
+
+	/*
+	 * Dictionary for the compressed nodes, nullptr without _ZSTD.
+	 * It is read once from xml_dictionary_path(), when first needed.
+	 */
+	Zstd_Dictionary *xml_compress_dictionary()
+	{
+#ifdef _ZSTD
+		this->xml_path_check();
+
+		if(this->xml_dictionary_checked == false)
+		{
+			this->xml_dictionary.clear();
+			this->xml_dictionary.set_previous_path(this->xml_directory_path() + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + "dictionary_");
+			this->xml_dictionary.file_read(this->xml_dictionary_path());
+			this->xml_dictionary_checked = true;
+		}
+
+		return &this->xml_dictionary;
+#else
+		return nullptr;
+#endif
+	}
+
+#ifdef _ZSTD
+	std::string xml_dictionary_path()
+	{
+		return this->xml_directory_path() + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + "dictionary.zstd";
+	}
+
+	/*
+	 * Trains the dictionary from up to sample_count of the loaded nodes,
+	 * spread over the list, and writes it next to the node files. Every
+	 * dictionary is also stored by its id, so the node files compressed
+	 * with an earlier one stay readable.
+	 */
+	int xml_dictionary_train(size_t sample_count = 1000, size_t dictionary_size = 16384)
+	{
+		XML_Options_Table options = this->flover->xml_options;
+		options.compress_node = false;
+
+		size_t step = (this->counter > sample_count && sample_count > 0) ? this->counter / sample_count : 1;
+		std::vector<std::string> samples;
+		T *node = this->first;
+		size_t index = 0;
+
+		while(node != nullptr && samples.size() < sample_count)
+		{
+			if(index % step == 0)
+			{
+				tinyxml2::XMLPrinter printer;
+				node->xml_create(&printer, options);
+
+				samples.emplace_back(printer.CStr(), printer.CStrSize() - 1);
+			}
+
+			node = node->next;
+			index++;
+		}
+
+		if(directory_exits_create(this->xml_directory_path()) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		Zstd_Dictionary *dictionary = this->xml_compress_dictionary();
+
+		// Written before 'dictionary_<id>' were kept
+		if(dictionary->is_loaded() && file_exits(dictionary->previous_file(dictionary->get_id())) == EXIT_FAILURE &&
+				dictionary->file_write(dictionary->previous_file(dictionary->get_id())) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		if(dictionary->train(samples, dictionary_size) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		if(dictionary->file_write(dictionary->previous_file(dictionary->get_id())) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		return dictionary->file_write(this->xml_dictionary_path());
+	}
+#endif
+
+	T *xml_node_parse(std::string xml_file)
+	{
+		return this->xml_node_parse(xml_file, this->load_options);
+	}
+
+	T *xml_node_parse(std::string xml_file, Node_Load_Options &options)
+	{
+		if(xml_file.empty() == false)
+		{
+			tinyxml2::XMLDocument document;
+			document.Parse(xml_file.c_str(), xml_file.size());
+			tinyxml2::XMLElement *root = document.RootElement();
+			std::string_view source = xml_file;
+			std::string xml_data;
+
+			if(root == nullptr)
+			{
+				return nullptr;
+			}
+
+#ifdef _ZLIB
+			if(std::strcmp(root->Value(), XML_STRING_COMPRESSED_ZLIB) == 0)
+			{
+				xml_data = xml_zlib_read_decompress(root);
+
+				if(xml_data.empty())
+				{
+					return nullptr;
+				}
+
+				document.Parse(xml_data.c_str(), xml_data.size());
+				root = document.RootElement();
+				source = xml_data;
+			}
+
+#endif
+#ifdef _ZSTD
+			if(std::strcmp(root->Value(), XML_STRING_COMPRESSED_ZSTD) == 0)
+			{
+				xml_data = xml_zstd_read_decompress(root, this->xml_compress_dictionary());
+
+				if(xml_data.empty())
+				{
+					return nullptr;
+				}
+
+				document.Parse(xml_data.c_str(), xml_data.size());
+				root = document.RootElement();
+				source = xml_data;
+			}
+
+#endif
+
+			if(root == nullptr)
+			{
+				return nullptr;
+			}
+
+			return this->xml_node_parse_root(root, options, source);
+		}
+
+		return nullptr;
+	}
+
+	/*
+	 * Creates a node from an already parsed root element.
+	 *
+	 * The privateID is checked before anything is allocated, so duplicates
+	 * are rejected early and the children are walked only once, by
+	 * xml_parse_loop().
+	 */
+	T *xml_node_parse_root(tinyxml2::XMLElement *root)
+	{
+		return this->xml_node_parse_root(root, this->load_options);
+	}
+
+	// source : text of root, kept by projected nodes of classes with their own xml_parse_loop(), see Node::xml_parse_loop_projected()
+
+	T *xml_node_parse_root(tinyxml2::XMLElement *root, Node_Load_Options &options, std::string_view source = std::string_view())
+	{
+		if(root == nullptr)
+		{
+			return nullptr;
+		}
+
+		Type_ID privateID = 0;
+
+		if(this->xml_peek_privateID(root, &privateID) == EXIT_SUCCESS)
+		{
+			if(this->_get_pointer_of_privateID(privateID) != nullptr)
+			{
+				return nullptr;
+			}
+		}
+
+		T *node = this->create();
+
+		if(node->xml_parse_loop_projected(root, options.fields, source) == EXIT_FAILURE)
+		{
+			this->del(node);
+			return nullptr;
+		}
+
+		this->name_index_update(node);
+
+		return node;
+	}
+
+	/*
+	 * Node::xml_create() writes the privateID as the first child, so this
+	 * normaly stops at the first element. Older files may have it further
+	 * down, then the siblings are searched.
+	 */
+	int xml_peek_privateID(tinyxml2::XMLElement *root, Type_ID *privateID)
+	{
+		if(root == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
+
+		tinyxml2::XMLElement *child = root->FirstChildElement();
+
+		while(child != nullptr)
+		{
+			if(std::strcmp(child->Value(), XML_STRING_PRIVATE XML_STRING_ID) == 0)
+			{
+				*privateID = variable_read<Type_ID>(child);
+				return EXIT_SUCCESS;
+			}
+
+			if(std::strcmp(child->Value(), XML_STRING_PRIVATE XML_STRING_ID XML_STRING_VARINT) == 0)
+			{
+				*privateID = varint_read<Type_ID>(child);
+				return EXIT_SUCCESS;
+			}
+
+			child = child->NextSiblingElement();
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	int node_exists_by_privateID(tinyxml2::XMLElement *root)
+	{
+		Type_ID id = 0;
+
+		if(this->xml_peek_privateID(root, &id) == EXIT_FAILURE)
+		{
+			return false;
+		}
+
+		if(this->_get_pointer_of_privateID(id) != nullptr)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	/*
+	T* xml_node_parse(std::string xml_file)
+	{
+	  if(xml_file.empty() == false)
+	  {
+		 T *node = this->create();
+
+		 if(node->xml_parse(xml_file) == EXIT_FAILURE)
+		 {
+			this->del(node);
+			return nullptr;
+		 }
+
+		 return node;
+	  }
+
+	  return nullptr;
+	}
+	*/
 
-		return EXIT_FAILURE;
-#endif
+	T *xml_node_parse(tinyxml2::XMLElement *element)
+	{
+		if(element != nullptr)
+		{
+			T *node = this->create();
+			node->xml_parse(element);
+			return node;
+		}
+
+		return nullptr;
 	}
 
-	int xml_file_listing_read()
+	virtual void xml_set_settings()
 	{
-		std::string data_path;
-#ifdef _FLOVER_
-		data_path = this->flover->options->get_xml_path() + this->get_node_path();
-#else
-		data_path = this->get_node_path();
+
+	}
+
+	int xml_listing_read(tinyxml2::XMLElement *element)
+	{
+		std::string name = element->Value();
+
+		if(name != this->xml_node_name + XML_STRING_LISTING)
+		{
+			return EXIT_FAILURE;
+		}
+
+		tinyxml2::XMLElement *child_element = element->FirstChildElement();
+
+		while(child_element != nullptr)
+		{
+			this->xml_listing_read_element(child_element);
+
+			child_element = child_element->NextSiblingElement();
+		}
+
+		return EXIT_SUCCESS;
+	}
+
+	// One child of the listing, manager values or a node
+	void xml_listing_read_element(tinyxml2::XMLElement *element)
+	{
+		std::string name = element->Value();
+
+		if(name == XML_STRING_MANAGER XML_STRING_VALUE XML_STRING_S)
+		{
+			this->xml_read_manager_values(element);
+		}
+
+		else if(name == this->xml_node_name)
+		{
+			T *node = this->create();
+			node->xml_parse_loop(element);
+			this->name_index_update(node);
+		}
+
+#ifdef _ZLIB
+		else if(name == XML_STRING_COMPRESSED_ZLIB)
+		{
+			this->xml_node_parse(xml_zlib_read_decompress(element));
+		}
 #endif
-		/*
-			 if(file_exits(data_path, this->flover->options) == EXIT_FAILURE)
-			 {
-				return EXIT_FAILURE;
-			 }
-		*/
-		std::string path = data_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE XML_STRING_LISTING XML_STRING_FILENAME_EXTENSION_XML;
+#ifdef _ZSTD
+		else if(name == XML_STRING_COMPRESSED_ZSTD)
+		{
+			this->xml_node_parse(xml_zstd_read_decompress(element, this->xml_compress_dictionary()));
+		}
+#endif
+	}
 
-		return this->xml_listing_read(file_read_text(this->flover->sync_table, path));
+	virtual int xml_write_manager_values(tinyxml2::XMLPrinter *printer)
+	{
+		if(printer != nullptr)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
 	}
 
-	int xml_files_write()
+	virtual void xml_read_manager_values( tinyxml2::XMLElement *element)
 	{
-#ifdef _SQL_DATABASE
 #ifdef _FLOVER_
-		if(this->flover->options->database_target == Data_Location::SQL)
+		if(this->flover != nullptr)
 		{
-			if(this->flover->sql_database == nullptr)
-			{
-				return EXIT_FAILURE;
-			}
+
 		}
-#endif
 #endif
 
-		T *node = this->first;
+		if(element != nullptr)
+		{
+			return void();
+		}
+	}
+
+	int xml_listing_read(std::string buffer)
+	{
+		if(buffer.empty())
+		{
+			return EXIT_FAILURE;
+		}
+
+		tinyxml2::XMLDocument document;
+		document.Parse(buffer.c_str(), buffer.size());
+		tinyxml2::XMLElement *element = document.RootElement();
+
+		if(element != nullptr)
+		{
+			this->xml_listing_read(element);
+		}
+
+		document.Clear();
+
+		if(this->first != nullptr)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+	int xml_listing_write(tinyxml2::XMLPrinter *printer, XML_Options_Table &options)
+	{
+		if(printer == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
+
+
+		T *node;
+		node = this->first;
 
 		if(node != nullptr)
 		{
-#ifdef _FLOVER_
-			if(this->flover->options->database_target != Data_Location::SQL)
-#else
-			if(this->flover->sync_table.target_sql)
-#endif
+			std::string listing_name = this->xml_node_name + XML_STRING_LISTING;
+
+			this->xml_write_manager_values(printer);
+
+			printer->OpenElement(listing_name.c_str(), options.no_empty_space);
+
+			while(node != nullptr)
 			{
-				std::string directory = this->get_node_path();
-#ifdef _FLOVER_
-				std::string data_path;
+				this->xml_set_node_settings(node);
+				node->xml_get(printer, options, this->xml_compress_dictionary());
 
-				if(this->flover->xml_options.target_dataFinal == false)
-				{
-					data_path = this->flover->options->get_xml_path();
-				}
+				node = node->next;
+			}
 
-				else
-				{
-					data_path = this->flover->options->get_dataFinal_path();
-				}
+			printer->CloseElement(options.no_empty_space);
 
-				if(directory_exits_create(data_path + directory) == EXIT_FAILURE)
-#else
-				if(directory_exits_create(directory) == EXIT_FAILURE)
-#endif
-				{
-					return EXIT_FAILURE;
-				}
+			return EXIT_SUCCESS;
+		}
 
-				do
-				{
-					if(node->privateID != 0)
-					{
-						std::string path =
-#ifdef _FLOVER_
-								data_path +
-#endif
-								directory + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(node->privateID)) + XML_STRING_FILENAME_EXTENSION_XML;
-						std::string xml_file = node->xml_get(this->flover->xml_options);
+		return EXIT_FAILURE;
+	}
 
-						file_write_text(path, xml_file);
-					}
+	int xml_listing_write(tinyxml2::XMLPrinter *printer)
+	{
+		if(printer == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
 
-					node = node->next;
-				}
-				while(node != nullptr);
 
-			}
+		T *node;
+		node = this->first;
 
-#ifdef _SQL_DATABASE
+		if(node != nullptr)
+		{
+			std::string listing_name = this->xml_node_name + XML_STRING_LISTING;
 
-			else
+			this->xml_write_manager_values(printer);
+
+			printer->OpenElement(listing_name.c_str(), this->flover->xml_options.no_empty_space);
+
+			while(node != nullptr)
 			{
+				this->xml_set_node_settings(node);
+				node->xml_get(printer, this->flover->xml_options, this->xml_compress_dictionary());
 
-				do
-				{
-					if(node->privateID != 0)
-					{
-						this->database_save(node);
-					}
+				node = node->next;
+			}
 
-					node = node->next;
+			printer->CloseElement(this->flover->xml_options.no_empty_space);
+
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	void xml_read_all_non_in_memory()
+	{
+		if(this->all_files_read)
+		{
+			return void();
+		}
+
+		Directory_Index *index = this->directory_index_get();
+
+		if(index != nullptr)
+		{
+			for(const Directory_Index_Entry &entry : index->get_entries())
+			{
+				if(this->is_loaded_privateID(entry.privateID) == EXIT_FAILURE)
+				{
+					this->load_file(entry.privateID);
 				}
-				while(node != nullptr);
 			}
 
+			this->all_files_read = true;
+
+			return void();
+		}
+
+		std::vector<std::string> files;
+
+		if(directory_listing_get(
+#ifdef _FLOVER_
+					this->flover->options->get_xml_path() +
 #endif
+					this->xml_node_name, &files) == EXIT_FAILURE)
+		{
+			return void();
+		}
 
-			EXIT_SUCCESS;
+		for(std::vector<std::string>::iterator it = files.begin(); it != files.end(); it++)
+		{
+			std::string base_ext = it->substr(it->find_first_of("_") + 1, it->find_first_of("."));
+			std::string temp = base_ext.substr(0, base_ext.find("."));
+
+			Type_ID id = uchar_to_variable<Type_ID>(base64Decode(temp));
+
+			if(this->is_loaded_privateID(id) == EXIT_FAILURE)
+			{
+				this->load_file(id);
+			}
 		}
 
-		return EXIT_FAILURE;
+		this->all_files_read = true;
 	}
 
-	void create_new_privateIDs(bool write_xml_files)
+	int is_loaded_privateID(Type_ID id)
 	{
-		Type_ID temp_id = 1;
-
-		T *node = this->first;
+		T *temp = this->first;
 
-		while(node != nullptr)
+		while(temp != nullptr)
 		{
-			node->privateID = temp_id;
-			temp_id++;
+			if(temp->privateID == id)
+			{
+				return EXIT_SUCCESS;
+			}
 
-			node = node->next;
+			temp = temp->next;
 		}
 
-		if(write_xml_files)
+		return EXIT_FAILURE;
+	}
+
+#ifdef _FLOVER_
+	void prepare_for_objectPlacer()
+	{
+		if(this->all_files_read == false)
 		{
-			this->xml_files_write();
+			this->xml_read_all_non_in_memory();
 		}
 	}
+#endif
 
-	int xml_file_write_by_pointer(T *node)
+	int current_set(T *node)
 	{
-		if(this->node_exists(node) == EXIT_SUCCESS)
+		if(node == nullptr)
 		{
-#ifdef _FLOVER_
-			std::string data_path = this->flover->options->get_xml_path() + this->xml_node_path;
-
-			if(directory_exits_create(data_path) == EXIT_FAILURE)
-			{
-				return EXIT_FAILURE;
-			}
+			this->current_prev = this->current;
+			this->tick_current_prev();
+			this->current = nullptr;
 
-			std::string path = data_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(node->privateID)) + XML_STRING_FILENAME_EXTENSION_XML;
-#else
-			std::string path = this->xml_node_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(node->privateID)) + XML_STRING_FILENAME_EXTENSION_XML;
-#endif
-			std::string xml_file;
+			return EXIT_SUCCESS;
+		}
 
-			tinyxml2::XMLPrinter printer;
-			node->xml_create(&printer, this->flover->xml_options);
+		if(this->node_exists(node) == EXIT_SUCCESS)
+		{
+			this->current_prev = this->current;
+			this->tick_current_prev();
 
-#ifdef _ZLIB
+			this->current = node;
 
-			if(this->flover->xml_options.compress_node)
+			if(this->current != nullptr)
 			{
-				std::string buffer = printer.CStr();
-				printer.ClearBuffer();
-				xml_string_compress_print(buffer, &printer, this->flover->xml_options);
+				this->current->set_is_current();
 			}
 
-#endif
+			this->current_changed = true;
 
-			xml_file = printer.CStr();
-			return file_write_text(path, xml_file);
+			return EXIT_SUCCESS;
 		}
 
 		return EXIT_FAILURE;
 	}
 
-	int xml_listing_file_write()
+	int current_set_by_id(Type_ID id,  bool privateID)
 	{
-#ifdef _FLOVER_
-		if(this->flover == nullptr)
+		if(privateID)
 		{
-			return EXIT_FAILURE;
+			return this->current_set(this->_get_pointer_of_privateID(id));
 		}
-#endif
 
-		std::string data_path;
-#ifdef _FLOVER_
-		if(this->flover->xml_options.target_dataFinal)
-		{
-			data_path = this->flover->options->get_dataFinal_path() + this->xml_node_path;
-		}
+		return this->current_set(this->get_pointer_of_id(id));
+	}
 
-		else
-		{
-			data_path = this->flover->options->get_xml_path() + this->xml_node_path;
-		}
-#else
-		data_path = this->xml_node_path;
-#endif
+	int current_set_by_id( Type_ID id)
+	{
+		return this->current_set(this->get_pointer_of_id(id));
+	}
 
-		if(directory_exits_create(data_path) == EXIT_FAILURE)
+	int current_set_by_privateID( Type_ID id)
+	{
+		return this->current_set(this->_get_pointer_of_privateID(id));
+	}
+
+	int current_to_next()
+	{
+		if(this->current != nullptr)
 		{
-			return EXIT_FAILURE;
+			if(this->current->next != nullptr)
+			{
+				this->current = this->current->next;
+				return EXIT_SUCCESS;
+			}
 		}
 
-		std::string path = data_path + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE XML_STRING_LISTING XML_STRING_FILENAME_EXTENSION_XML;
-		std::string xml_file;
-		tinyxml2::XMLPrinter printer;
-		this->xml_listing_write(&printer);
-		xml_file = printer.CStr();
-		return file_write_text(path, xml_file);
+		return EXIT_FAILURE;
 	}
 
-	int xml_file_delete_by_privateID(Type_ID privateID)
+	int current_to_prev()
 	{
-		if(privateID != 0)
+		if(this->current != nullptr)
 		{
-			std::string path = std::string(
-#ifdef _FLOVER_
-						this->flover->options->get_xml_path() +
-#endif
-											this->xml_node_path + XML_STRING_SLASH +
-											this->xml_node_name + XML_STRING_UNDERSCORE + base64Encode(variable_to_uchar<Type_ID>(privateID)) + XML_STRING_FILENAME_EXTENSION_XML);
-			return std::remove(path.c_str());
+			if(this->current->prev != nullptr)
+			{
+				this->current = this->current->prev;
+				return EXIT_SUCCESS;
+			}
 		}
 
 		return EXIT_FAILURE;
 	}
 
-	void xml_set_node_settings(T *node)
+	int current_set_secondary_by_privateID( Type_ID id)
 	{
-		node->xml_set_node_infos(this->xml_node_name);
+		T *temp = this->_get_pointer_of_privateID(id);
+
+		if(temp != nullptr)
+		{
+			this->current_secondary = temp;
+			return EXIT_SUCCESS;
+		}
+
+		return EXIT_FAILURE;
 	}
 
-	T *xml_node_parse(std::string xml_file)
+	void tick_current_prev()
 	{
-		if(xml_file.empty() == false)
+		if(this->node_exists(this->current_prev) == EXIT_SUCCESS)
 		{
-			tinyxml2::XMLDocument document;
-			document.Parse(xml_file.c_str(), xml_file.size());
-			tinyxml2::XMLElement *root = document.RootElement();
+			this->current_prev->set_not_current();
+		}
 
-			if(root == nullptr)
-			{
-				return nullptr;
-			}
+		else
+		{
+			this->current_prev = nullptr;
+		}
+	}
 
-			tinyxml2::XMLElement *child = root->FirstChildElement();
+	virtual int files_create(std::string path,  bool one_path = true)
+	{
+		if(path.empty() == false && one_path == false)
+		{
 
-#ifdef _ZLIB
-			std::string xml_name = root->Value();
+		}
 
-			if(xml_name == XML_STRING_COMPRESSED_ZLIB)
-			{
-				std::vector<uint8_t> data;
-				data = base64Decode(get_std_string(root));
+		return EXIT_FAILURE;
+	}
 
-				if(data.empty())
-				{
-					return nullptr;
-				}
+	T *first;
+	T *last;
 
-				std::string xml_data = std_string_decompress(data);
+	T *current;
+	T *current_prev;
+	bool current_changed;
+	bool is_child_manager;
 
-				document.Parse(xml_data.c_str(), xml_data.size());
-				root = document.RootElement();
+	Type_ID nextID;
+	unsigned int counter;
+	bool remove_unneeded;
+	bool all_files_read;
 
-				if(root == nullptr)
-				{
-					return nullptr;
-				}
+	std::string xml_node_name;
+	std::string xml_node_path;
 
-				child = root->FirstChildElement();
-			}
+	/*
+	 * Fields loaded by load_file() and xml_node_parse(),
+	 * the rest is faulted in on first access.
+	 */
+	Node_Load_Options load_options;
 
+#ifdef _NODE_INFO_COMPACT
+	// Strings of the nodes, see Node_Info. collect() after deleting many nodes.
+	String_Pool string_pool;
+	Interned_String xml_node_tag;
 #endif
 
-			if(this->node_exists_by_privateID(root) == true)
-			{
-				return nullptr;
-			}
+private:
 
-			T *node = this->create();
+	std::string xml_file_path(const char *encoded, size_t size, bool data_final)
+	{
+		std::string path;
+		this->xml_file_path_format(encoded, size, data_final, path);
 
-			if(node->xml_parse_loop(root) == EXIT_FAILURE)
-			{
-				this->del(node);
-				return nullptr;
-			}
+		return path;
+	}
 
-			return node;
-		}
+	void xml_file_path_format(const char *encoded, size_t size, bool data_final, std::string &path)
+	{
+		this->xml_path_check();
 
-		return nullptr;
+		path.reserve(this->xml_file_prefix[data_final].size() + size + sizeof(XML_STRING_FILENAME_EXTENSION_XML));
+		path.assign(this->xml_file_prefix[data_final]);
+		path.append(encoded, size);
+		path.append(XML_STRING_FILENAME_EXTENSION_XML);
 	}
 
-	int node_exists_by_privateID(tinyxml2::XMLElement *root)
+	// The paths are computed once, until xml_path_reset()
+	void xml_path_check()
 	{
-		if(root == nullptr)
+		if(this->xml_path_valid)
 		{
-			return 0;
+			return void();
 		}
-		tinyxml2::XMLElement *child = root->FirstChildElement();
-
-		std::string text ;
 
-		while(child != nullptr)
-		{
-			text = child->Value();
-			if(text == XML_STRING_PRIVATE XML_STRING_ID)
-			{
-				Type_ID id = variable_read<Type_ID>(child);
+#ifdef _FLOVER_
+		std::string xml_path = this->flover->options->get_xml_path();
+		std::string final_path = this->flover->options->get_dataFinal_path();
+#else
+		std::string xml_path;
+		std::string final_path;
+#endif
 
-				if(this->_get_pointer_of_privateID(id) != nullptr)
-				{
-					return true;
-				}
-				else
-				{
-					return false;
-				}
-			}
+		this->xml_directory[0] = xml_path + this->xml_node_path;
+		this->xml_directory[1] = final_path + this->xml_node_path;
 
-			child = child->NextSiblingElement();
+		for(int i = 0; i < 2; i++)
+		{
+			this->xml_file_prefix[i] = this->xml_directory[i] + XML_STRING_SLASH + this->xml_node_name + XML_STRING_UNDERSCORE;
 		}
 
+		this->xml_path_valid = true;
 	}
 
 	/*
-	T* xml_node_parse(std::string xml_file)
+	 * Copies of the last snapshot, weak so that copies are freed with the
+	 * snapshots. Stamps are unique, so a new node at the address of a
+	 * deleted one is never taken for it.
+	 */
+	struct Snapshot_Version
 	{
-	  if(xml_file.empty() == false)
-	  {
-		 T *node = this->create();
-
-		 if(node->xml_parse(xml_file) == EXIT_FAILURE)
-		 {
-			this->del(node);
-			return nullptr;
-		 }
-
-		 return node;
-	  }
+		uint64_t stamp;
+		std::weak_ptr<const T> node;
+	};
 
-	  return nullptr;
-	}
-	*/
-
-	T *xml_node_parse(tinyxml2::XMLElement *element)
+	// Indexes of the manager and then the hooks of the derived classes
+	void indexes_add(T *node)
 	{
-		if(element != nullptr)
+		if(this->name_index_enabled)
 		{
-			T *node = this->create();
-			node->xml_parse(element);
-			return node;
+			this->name_index.add(node, *node->get_name());
 		}
 
-		return nullptr;
-	}
-
-	virtual void xml_set_settings()
-	{
-
+		this->index_add(node);
 	}
 
-	int xml_listing_read(tinyxml2::XMLElement *element)
+	void indexes_remove(T *node)
 	{
-		std::string name = element->Value();
-
-		if(name != this->xml_node_name + XML_STRING_LISTING)
+		if(node->pins != 0 && this->depency_batch.empty() == false)
 		{
-			return EXIT_FAILURE;
+			this->depency_batch.erase(std::remove_if(this->depency_batch.begin(), this->depency_batch.end(), [node](const Depency_Request &request)
+			{
+				return request.owner_pins == &node->pins;
+			}), this->depency_batch.end());
 		}
 
-		tinyxml2::XMLElement *child_element = element->FirstChildElement();
-
-		while(child_element != nullptr)
+		if(this->name_index_enabled)
 		{
-			name = child_element->Value();
-
-			if(name == XML_STRING_MANAGER XML_STRING_VALUE XML_STRING_S)
-			{
-				this->xml_read_manager_values(child_element);
-			}
-
-			else if(name == this->xml_node_name)
-			{
-				T *node = this->create();
-				node->xml_parse_loop(child_element);
-			}
-
-#ifdef _ZLIB
-			else if(name == XML_STRING_COMPRESSED_ZLIB)
-			{
-				this->xml_node_parse(xml_string_read_decompress(child_element));
-			}
-#endif
+			this->name_index.remove(node);
+		}
 
-			child_element = child_element->NextSiblingElement();
+		if(this->resident_budget != 0)
+		{
+			this->residency_remove(node);
 		}
 
-		return EXIT_SUCCESS;
+		this->index_remove(node);
 	}
 
-	virtual int xml_write_manager_values(tinyxml2::XMLPrinter *printer)
+	void text_index_node_update(T *node)
 	{
-		if(printer != nullptr)
+		if(node->privateID != 0)
 		{
-			return EXIT_SUCCESS;
+			this->text_index_get()->update(node->privateID, {*node->get_info(), *node->get_memo()});
 		}
+	}
+
+	/*
+	 * Nodes under the memory budget, in the ring of CLOCK. stamp is the
+	 * modified stamp, when the node was loaded or last written.
+	 */
+	struct Resident
+	{
+		T *node;
+		size_t size;
+		uint64_t stamp;
+		bool referenced;
+	};
 
-		return EXIT_FAILURE;
+	// The node as stored in the cold store
+	std::string residency_xml(T *node)
+	{
+		XML_Options_Table options = this->flover->xml_options;
+		options.compress_node = false;
+
+		tinyxml2::XMLPrinter printer(nullptr, true);
+		node->xml_create(&printer, options);
+
+		return std::string(printer.CStr(), printer.CStrSize() - 1);
 	}
 
-	virtual void xml_read_manager_values( tinyxml2::XMLElement *element)
+	void residency_add(T *node)
 	{
-#ifdef _FLOVER_
-		if(this->flover != nullptr)
-		{
+		node->node_flags.bit_set(Node_Flags::Needed, false);
 
-		}
-#endif
+		Resident resident = {node, node->memory_size(), node->get_modified_stamp(), true};
+		this->resident_positions[node] = this->resident_ring.size();
+		this->resident_ring.push_back(resident);
+		this->resident_memory += resident.size;
 
-		if(element != nullptr)
-		{
-			return void();
-		}
+		this->residency_evict(node);
 	}
 
-	int xml_listing_read(std::string buffer)
+	void residency_reference(T *node)
 	{
-		if(buffer.empty())
+		auto found = this->resident_positions.find(node);
+
+		if(found != this->resident_positions.end())
 		{
-			return EXIT_FAILURE;
+			this->resident_ring[found->second].referenced = true;
 		}
+	}
 
-		tinyxml2::XMLDocument document;
-		document.Parse(buffer.c_str(), buffer.size());
-		tinyxml2::XMLElement *element = document.RootElement();
-
-		if(element != nullptr)
+	void residency_clean(T *node)
+	{
+		if(this->resident_budget == 0)
 		{
-			this->xml_listing_read(element);
+			return void();
 		}
 
-		document.Clear();
+		auto found = this->resident_positions.find(node);
 
-		if(this->first != nullptr)
+		if(found != this->resident_positions.end())
 		{
-			return EXIT_SUCCESS;
+			this->resident_ring[found->second].stamp = node->get_modified_stamp();
 		}
-
-		return EXIT_FAILURE;
 	}
-	int xml_listing_write(tinyxml2::XMLPrinter *printer, XML_Options_Table &options)
+
+	// Leaves a hole to keep the order of the ring, the holes are removed at once
+	void residency_remove(T *node)
 	{
-		if(printer == nullptr)
+		auto found = this->resident_positions.find(node);
+
+		if(found == this->resident_positions.end())
 		{
-			return EXIT_FAILURE;
+			return void();
 		}
 
+		Resident &resident = this->resident_ring[found->second];
+		this->resident_memory -= resident.size;
+		resident.node = nullptr;
+		resident.size = 0;
 
-		T *node;
-		node = this->first;
+		this->resident_positions.erase(found);
+		this->resident_removed++;
 
-		if(node != nullptr)
+		if(this->resident_removed > this->resident_ring.size() / 2)
 		{
-			std::string listing_name = this->xml_node_name + XML_STRING_LISTING;
-
-			this->xml_write_manager_values(printer);
+			this->residency_compact();
+		}
+	}
 
-			printer->OpenElement(listing_name.c_str(), options.no_empty_space);
+	void residency_compact()
+	{
+		size_t count = 0;
+		size_t hand = 0;
 
-			while(node != nullptr)
+		for(size_t i = 0; i < this->resident_ring.size(); i++)
+		{
+			if(i == this->resident_hand)
 			{
-				node->xml_set_node_infos(this->xml_node_name);
-				node->xml_get(printer, options);
-
-				node = node->next;
+				hand = count;
 			}
 
-			printer->CloseElement(options.no_empty_space);
-
-			return EXIT_SUCCESS;
+			if(this->resident_ring[i].node != nullptr)
+			{
+				this->resident_ring[count] = this->resident_ring[i];
+				this->resident_positions[this->resident_ring[count].node] = count;
+				count++;
+			}
 		}
 
-		return EXIT_FAILURE;
+		this->resident_ring.resize(count);
+		this->resident_hand = hand;
+		this->resident_removed = 0;
 	}
 
-	int xml_listing_write(tinyxml2::XMLPrinter *printer)
+	/*
+	 * Sizes are measured again as the hand passes, the first turn clears
+	 * the reference bits, so two turns are enough to find all candidates.
+	 * Evicting leaves a hole, so the hand moves on by itself.
+	 */
+	void residency_evict(T *keep)
 	{
-		if(printer == nullptr)
-		{
-			return EXIT_FAILURE;
-		}
+		size_t steps = 2 * this->resident_ring.size();
 
+		while(this->resident_memory > this->resident_budget && this->resident_ring.empty() == false && steps > 0)
+		{
+			if(this->resident_hand >= this->resident_ring.size())
+			{
+				this->resident_hand = 0;
+			}
 
-		T *node;
-		node = this->first;
+			Resident &resident = this->resident_ring[this->resident_hand];
+			T *node = resident.node;
 
-		if(node != nullptr)
-		{
-			std::string listing_name = this->xml_node_name + XML_STRING_LISTING;
+			if(node == nullptr)
+			{
+				this->resident_hand++;
+				continue;
+			}
 
-			this->xml_write_manager_values(printer);
+			this->resident_memory -= resident.size;
+			resident.size = node->memory_size();
+			this->resident_memory += resident.size;
+			steps--;
 
-			printer->OpenElement(listing_name.c_str(), this->flover->xml_options.no_empty_space);
+			if(resident.referenced)
+			{
+				resident.referenced = false;
+				this->resident_hand++;
+				continue;
+			}
 
-			while(node != nullptr)
+			if(node == keep || node == this->current || node == this->current_prev ||
+					node->node_flags.bit_get(Node_Flags::Needed) || node->pins != 0)
 			{
-				node->xml_set_node_infos(this->xml_node_name);
-				node->xml_get(printer, this->flover->xml_options);
+				this->resident_hand++;
+				continue;
+			}
 
-				node = node->next;
+			if(node->get_modified_stamp() != resident.stamp && this->xml_file_write_node(node) == EXIT_FAILURE)
+			{
+				this->resident_hand++;
+				continue;
 			}
 
-			printer->CloseElement(this->flover->xml_options.no_empty_space);
+			this->cold_store_put(node);
+			this->resident_evictions++;
 
-			return EXIT_SUCCESS;
+			node->runtime_clear();
+			this->unlink(node);
+			delete node;
 		}
 
-		return EXIT_FAILURE;
+#ifdef _NODE_INFO_COMPACT
+		this->string_pool.collect_needed();
+#endif
 	}
 
-	void xml_read_all_non_in_memory()
+	void cold_store_put(T *node)
 	{
-		if(this->all_files_read)
+		if(this->cold_store.get_budget() == 0 || node->privateID == 0)
 		{
 			return void();
 		}
 
-		std::vector<std::string> files;
+		this->cold_store.put(node->privateID, this->residency_xml(node));
+	}
 
-		if(directory_listing_get(
-#ifdef _FLOVER_
-					this->flover->options->get_xml_path() +
-#endif
-					this->xml_node_name, &files) == EXIT_FAILURE)
-		{
-			return void();
-		}
+	T *cold_store_take(Type_ID privateID)
+	{
+		std::string xml;
 
-		for(std::vector<std::string>::iterator it = files.begin(); it != files.end(); it++)
+		if(this->cold_store.take(privateID, xml) == EXIT_FAILURE)
 		{
-			std::string base_ext = it->substr(it->find_first_of("_") + 1, it->find_first_of("."));
-			std::string temp = base_ext.substr(0, base_ext.find("."));
+			return nullptr;
+		}
 
-			Type_ID id = uchar_to_variable<Type_ID>(base64Decode(temp));
+		T *node = this->xml_node_parse(std::move(xml), this->load_options);
 
-			if(this->is_loaded_privateID(id) == EXIT_FAILURE)
-			{
-				this->load_file(id);
-			}
+		if(node != nullptr)
+		{
+			this->cold_hits++;
 		}
 
-		this->all_files_read = true;
+		return node;
 	}
 
-	int is_loaded_privateID(Type_ID id)
+	struct Prefetch_Read
 	{
-		T *temp = this->first;
-
-		while(temp != nullptr)
-		{
-			if(temp->privateID == id)
-			{
-				return EXIT_SUCCESS;
-			}
+		std::future<std::string> xml;
+		unsigned int depth;
+	};
 
-			temp = temp->next;
-		}
+	void prefetch_read(Type_ID privateID, unsigned int depth)
+	{
+		std::string path = this->xml_file_path(privateID);
 
-		return EXIT_FAILURE;
-	}
+		Prefetch_Read read;
+		read.depth = depth;
 
-#ifdef _FLOVER_
-	void prepare_for_objectPlacer()
-	{
-		if(this->all_files_read == false)
+		// Read like load_file(), with a copy of the table for the other thread
+		read.xml = std::async(std::launch::async, [path, table = this->flover->sync_table]() mutable
 		{
-			this->xml_read_all_non_in_memory();
-		}
+			return file_read_text(table, path);
+		});
+
+		this->prefetch_reads.emplace(privateID, std::move(read));
 	}
-#endif
 
-	int current_set(T *node)
+	// Node not in memory from the cold store, its file or the database
+	T *privateID_load(Type_ID id)
 	{
-		if(node == nullptr)
-		{
-			this->current_prev = this->current;
-			this->tick_current_prev();
-			this->current = nullptr;
+		// The cold store and the filter are of the current paths
+		this->xml_path_check();
 
-			return EXIT_SUCCESS;
+		if(this->privateID_filter_may_exist(id) == false)
+		{
+			return nullptr;
 		}
 
-		if(this->node_exists(node) == EXIT_SUCCESS)
-		{
-			this->current_prev = this->current;
-			this->tick_current_prev();
+		T *temp = this->cold_store_take(id);
 
-			this->current = node;
+		if(temp == nullptr)
+		{
+			temp = this->load_file(id);
 
-			if(this->current != nullptr)
+			if(temp != nullptr)
 			{
-				this->current->set_is_current();
+				this->resident_loads++;
 			}
+		}
 
-			this->current_changed = true;
-
-			return EXIT_SUCCESS;
+		if(temp != nullptr && this->resident_budget != 0)
+		{
+			this->residency_add(temp);
 		}
 
-		return EXIT_FAILURE;
-	}
+#ifdef _SQL_DATABASE
 
-	int current_set_by_id(Type_ID id,  bool privateID)
-	{
-		if(privateID)
+		if(temp == nullptr &&
+	#ifdef _FLOVER_
+				this->flover->options->database_location == Data_Location::SQL)
+#else
+				this->flover->sync_table.target_sql)
+#endif
 		{
-			return this->current_set(this->_get_pointer_of_privateID(id));
+			temp = this->database_get_by_privateID(id);
 		}
 
-		return this->current_set(this->get_pointer_of_id(id));
-	}
+#endif
 
-	int current_set_by_id( Type_ID id)
-	{
-		return this->current_set(this->get_pointer_of_id(id));
+		return temp;
 	}
 
-	int current_set_by_privateID( Type_ID id)
+	struct Depency_Request
 	{
-		return this->current_set(this->_get_pointer_of_privateID(id));
-	}
+		Type_ID privateID;
+		unsigned int *owner_pins;
+		std::function<void(T *node)> resolve;
+	};
 
-	int current_to_next()
+	// Waits for the read if it is not done, nullptr if the node is in memory already
+	T *prefetch_parse(Type_ID privateID, Node_Load_Options &options)
 	{
-		if(this->current != nullptr)
+		auto found = this->prefetch_reads.find(privateID);
+		std::string xml = found->second.xml.get();
+		unsigned int depth = found->second.depth;
+
+		this->prefetch_reads.erase(found);
+
+		T *node = this->xml_node_parse(std::move(xml), options);
+
+		if(node == nullptr)
 		{
-			if(this->current->next != nullptr)
-			{
-				this->current = this->current->next;
-				return EXIT_SUCCESS;
-			}
+			return nullptr;
 		}
 
-		return EXIT_FAILURE;
-	}
+		// Not asked for yet, so delete_unneeded() may drop it
+		node->node_flags.bit_set(Node_Flags::Needed, false);
 
-	int current_to_prev()
-	{
-		if(this->current != nullptr)
+		if(depth > 1)
 		{
-			if(this->current->prev != nullptr)
-			{
-				this->current = this->current->prev;
-				return EXIT_SUCCESS;
-			}
+			node->depency_prefetch(depth - 1);
 		}
 
-		return EXIT_FAILURE;
+		return node;
 	}
 
-	int current_set_secondary_by_privateID( Type_ID id)
+	// Before the manager changes the directory, so that the index takes its new mtime after
+	void directory_index_writing()
 	{
-		T *temp = this->_get_pointer_of_privateID(id);
-
-		if(temp != nullptr)
+		if(this->directory_index_enabled == false || this->directory_index_checked == false)
 		{
-			this->current_secondary = temp;
-			return EXIT_SUCCESS;
+			return void();
 		}
 
-		return EXIT_FAILURE;
+		this->directory_index.update(this->xml_directory_path(), this->xml_node_name + XML_STRING_UNDERSCORE, XML_STRING_FILENAME_EXTENSION_XML);
 	}
 
-	void tick_current_prev()
+	// After the file of node has been written with content
+	void directory_index_written(T *node, std::string_view content)
 	{
-		if(this->node_exists(this->current_prev) == EXIT_SUCCESS)
+		if(this->directory_index_enabled == false || this->directory_index_checked == false)
 		{
-			this->current_prev->set_not_current();
+			return void();
 		}
 
-		else
-		{
-			this->current_prev = nullptr;
-		}
+		std::string name = this->xml_node_name + XML_STRING_UNDERSCORE + node->get_encoded_privateID() + XML_STRING_FILENAME_EXTENSION_XML;
+		this->directory_index.file_written(this->xml_directory_path(), name, node->privateID, content);
 	}
 
-	virtual int files_create(std::string path,  bool one_path = true)
+	void privateID_filter_add(Type_ID privateID)
 	{
-		if(path.empty() == false && one_path == false)
+		if(this->privateID_filter_valid == false)
 		{
-
+			return void();
 		}
 
-		return EXIT_FAILURE;
-	}
-
-	T *first;
-	T *last;
+		this->privateID_filter.add(uint64_t(privateID));
 
-	T *current;
-	T *current_prev;
-	bool current_changed;
-	bool is_child_manager;
+		if(this->privateID_filter.get_count() > this->privateID_filter.get_capacity())
+		{
+			this->privateID_filter_valid = false;
+		}
+	}
 
-	Type_ID nextID;
-	unsigned int counter;
-	bool remove_unneeded;
-	bool all_files_read;
+	std::unordered_map<const T*, Snapshot_Version> snapshot_versions;
+	std::shared_ptr<const Manager_Snapshot<T>> snapshot_last;
+	uint64_t snapshot_counter;
+
+	// Declared after string_pool, so destroyed before it
+	Name_Index<T> name_index;
+	bool name_index_enabled;
+
+	Text_Index text_index;
+	bool text_index_enabled;
+	bool text_index_checked;
+
+	std::vector<Resident> resident_ring;
+	std::unordered_map<const T*, size_t> resident_positions;
+	size_t resident_hand;
+	size_t resident_removed;
+	size_t resident_memory;
+	size_t resident_budget;
+	uint64_t resident_hits;
+	uint64_t resident_loads;
+	uint64_t resident_evictions;
+
+	Cold_Store cold_store;
+	uint64_t cold_hits;
+
+	std::unordered_map<Type_ID, Prefetch_Read> prefetch_reads;
+	unsigned int prefetch_depth;
+	size_t prefetch_max;
+
+	std::vector<Depency_Request> depency_batch;
+
+	Bloom_Filter privateID_filter;
+	bool privateID_filter_enabled;
+	bool privateID_filter_valid;
+
+	Directory_Index directory_index;
+	bool directory_index_enabled;
+	bool directory_index_checked;
+
+	bool xml_path_valid;
+#ifdef _ZSTD
+	bool xml_dictionary_checked;
+	Zstd_Dictionary xml_dictionary;
+#endif
+	std::string xml_directory[2];
+	std::string xml_file_prefix[2];
+	// Reused by the manager for the paths it uses at once
+	std::string xml_path_buffer;
 
-	std::string xml_node_name;
-	std::string xml_node_path;
+public:
 
 #ifdef _FLOVER_
 
@@ -2051,24 +4080,47 @@ public:
 
 		std::string path;
 		std::string buffer;
+		std::vector<std::string> paths;
+		Directory_Index *index = data_path == this->xml_directory_path() ? this->directory_index_get() : nullptr;
+
+		if(index != nullptr)
+		{
+			for(const Directory_Index_Entry &entry : index->get_entries())
+			{
+				paths.push_back(data_path + XML_STRING_SLASH + entry.name);
+			}
+		}
 
+		else
+		{
 #ifdef __WASM__
 
-		for(auto &p : std::__fs::filesystem::directory_iterator(data_path))
+			for(auto &p : std::__fs::filesystem::directory_iterator(data_path))
 #else
-		for(auto &p : std::filesystem::directory_iterator(data_path))
+			for(auto &p : std::filesystem::directory_iterator(data_path))
 #endif
+			{
+				paths.push_back(p.path().string());
+			}
+		}
+
+		for(const std::string &file : paths)
 		{
+#ifdef __WASM__
+			std::__fs::filesystem::path p(file);
+#else
+			std::filesystem::path p(file);
+#endif
 			buffer.clear();
 			path.clear();
 
-			path = p.path().filename().string();
+			path = p.filename().string();
 
 			T *node = this->files->create();
 
 			if(this->flover->sync_table.peek_nodeInfo)
 			{
-				path = p.path().string();
+				path = p.string();
 				buffer = file_read_text(this->flover->sync_table, path);
 
 				if(buffer.empty())
@@ -2091,7 +4143,7 @@ public:
 					{
 						if(node->info.name.empty())
 						{
-							node->info.name = p.path().stem().string();
+							node->info.set_name(p.stem().string());
 						}
 
 						break;
@@ -2103,13 +4155,15 @@ public:
 
 			else
 			{
-				std::string coded = p.path().stem().string().substr(p.path().stem().string().find_first_of("_")+1, p.path().stem().string().find_first_of("."));
+				std::string coded = p.stem().string().substr(p.stem().string().find_first_of("_")+1, p.stem().string().find_first_of("."));
 				node->privateID = uchar_to_variable<Type_ID>(base64Decode(coded));
-				node->info.name = p.path().stem().string();
+				node->info.set_name(p.stem().string());
 			}
 
+			this->files->name_index_update(node);
+
 #ifdef _DEBUG
-			std::cout << node->info.name << std::endl;
+			std::cout << std::string_view(node->info.name) << std::endl;
 #endif
 		}
 
@@ -0,0 +1,107 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Manager_Snapshot.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __MANAGER_SNAPSHOT
+#define __MANAGER_SNAPSHOT
+
+#include <Common_Types.h>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+template <class T>
+class Manager;
+
+/*
+ * Immutable view of the nodes of a manager at one moment, made by
+ * Manager::snapshot(). It can be read from any thread without locks.
+ * Every node is a shared copy, which unmodified nodes share with the
+ * earlier and later snapshots, a copy is freed with the last snapshot
+ * holding it. The list pointers of the copies are nullptr, iterate
+ * with get_nodes() or at().
+ */
+template <class T>
+class Manager_Snapshot
+{
+public:
+	typedef std::shared_ptr<const T> Node_Pointer;
+
+	uint64_t get_version() const
+	{
+		return this->version;
+	}
+
+	size_t size() const
+	{
+		return this->nodes.size();
+	}
+
+	const T *at(size_t index) const
+	{
+		if(index >= this->nodes.size())
+		{
+			return nullptr;
+		}
+
+		return this->nodes[index].get();
+	}
+
+	const std::vector<Node_Pointer> &get_nodes() const
+	{
+		return this->nodes;
+	}
+
+	const T *get_pointer_of_privateID(Type_ID privateID) const
+	{
+		auto found = std::lower_bound(this->privateIDs.begin(), this->privateIDs.end(), std::make_pair(privateID, (size_t)0));
+
+		if(found == this->privateIDs.end() || found->first != privateID)
+		{
+			return nullptr;
+		}
+
+		return this->nodes[found->second].get();
+	}
+
+private:
+	friend class Manager<T>;
+
+	uint64_t version = 0;
+	std::vector<Node_Pointer> nodes;
+	// Sorted pairs of privateID and index to nodes
+	std::vector<std::pair<Type_ID, size_t>> privateIDs;
+};
+#endif
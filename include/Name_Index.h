@@ -0,0 +1,191 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Name_Index.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __NAME_INDEX
+#define __NAME_INDEX
+
+#include <Node_Info.h>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Index of node names for Manager, a hash for exact matches and a sorted
+ * array for prefixes. The names are copies of Node_Info_String, so with
+ * _NODE_INFO_COMPACT they are shared with the nodes. The array is sorted
+ * again on the first prefix search after changes.
+ */
+template <class T>
+class Name_Index
+{
+public:
+
+	Name_Index()
+	{
+		this->sorted_valid = true;
+	}
+
+	void clear()
+	{
+		this->exact.clear();
+		this->names.clear();
+		this->sorted.clear();
+		this->sorted_valid = true;
+	}
+
+	size_t size() const
+	{
+		return this->names.size();
+	}
+
+	// Replaces the earlier entry of the node, empty names are not indexed
+	void add(T *node, const Node_Info_String &name)
+	{
+		this->remove(node);
+
+		if(name.empty())
+		{
+			return void();
+		}
+
+		auto result = this->names.emplace(node, name);
+		this->exact.emplace(std::string_view(result.first->second), node);
+		this->sorted_valid = false;
+	}
+
+	void remove(T *node)
+	{
+		auto found = this->names.find(node);
+
+		if(found == this->names.end())
+		{
+			return void();
+		}
+
+		auto range = this->exact.equal_range(std::string_view(found->second));
+
+		for(auto i = range.first; i != range.second; ++i)
+		{
+			if(i->second == node)
+			{
+				this->exact.erase(i);
+				break;
+			}
+		}
+
+		this->names.erase(found);
+		this->sorted_valid = false;
+	}
+
+	// One of the nodes with the name, nullptr if none
+	T *find(std::string_view name) const
+	{
+		auto found = this->exact.find(name);
+
+		if(found == this->exact.end())
+		{
+			return nullptr;
+		}
+
+		return found->second;
+	}
+
+	void find_all(std::string_view name, std::vector<T*> &result) const
+	{
+		auto range = this->exact.equal_range(name);
+
+		for(auto i = range.first; i != range.second; ++i)
+		{
+			result.push_back(i->second);
+		}
+	}
+
+	// Nodes in the order of the names, at most max_count of them when it is not 0
+	void find_prefix(std::string_view prefix, std::vector<T*> &result, size_t max_count = 0)
+	{
+		if(this->sorted_valid == false)
+		{
+			this->sort();
+		}
+
+		auto i = std::lower_bound(this->sorted.begin(), this->sorted.end(), prefix, [](const Entry &entry, std::string_view value)
+		{
+			return entry.first < value;
+		});
+
+		size_t count = 0;
+
+		for(; i != this->sorted.end() && i->first.substr(0, prefix.size()) == prefix; ++i)
+		{
+			if(max_count != 0 && count == max_count)
+			{
+				break;
+			}
+
+			result.push_back(i->second);
+			count++;
+		}
+	}
+
+private:
+
+	typedef std::pair<std::string_view, T*> Entry;
+
+	void sort()
+	{
+		this->sorted.clear();
+		this->sorted.reserve(this->names.size());
+
+		for(auto &name : this->names)
+		{
+			this->sorted.emplace_back(std::string_view(name.second), name.first);
+		}
+
+		std::sort(this->sorted.begin(), this->sorted.end(), [](const Entry &a, const Entry &b)
+		{
+			return a.first < b.first;
+		});
+
+		this->sorted_valid = true;
+	}
+
+	// The views of exact and sorted point to the strings of names
+	std::unordered_map<T*, Node_Info_String> names;
+	std::unordered_multimap<std::string_view, T*> exact;
+	std::vector<Entry> sorted;
+	bool sorted_valid;
+};
+
+#endif
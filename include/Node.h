@@ -41,6 +41,7 @@
 #include <Sync_Table.h>
 #include <Common_Functions.h>
 #include <Node_Info.h>
+#include <Node_Fields.h>
 #include <BitField.h>
 #ifdef _XML_SUPPORT
 #include <helpers_tinyxml2.h>
@@ -50,10 +51,22 @@
 #include <Node_Info.h>
 #endif
 
+#include <atomic>
+#include <cstdint>
+
+#ifdef _XML_SUPPORT
+#include <cstring>
+#include <type_traits>
+
+// Size of the Base64 encoded privateID with the terminating null
+#define XML_ENCODED_PRIVATEID_SIZE (((sizeof(Type_ID) + 2) / 3) * 4 + 1)
+#endif
+
 #ifdef _FLOVER_
 class Flover;
 #endif
 struct Node_Info;
+class Zstd_Dictionary;
 
 
 template <class T>
@@ -61,26 +74,78 @@ class Node
 {
 public:
 
-	virtual std::string *get_name()
+	virtual Node_Info_String *get_name()
 	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Name);
+#endif
 		return &this->info.name;
 	}
 
 	virtual std::string get_name_string()
 	{
-		return this->info.name;
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Name);
+#endif
+		return std::string(std::string_view(this->info.name));
 	}
 
-	virtual std::string *get_info()
+	virtual Node_Info_String *get_info()
 	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Info);
+#endif
 		return &this->info.info;
 	}
 
-	virtual std::string *get_memo()
+	virtual Node_Info_String *get_memo()
 	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Memo);
+#endif
 		return &this->info.memo;
 	}
 
+	// The whole Node_Info faulted in, to be used instead of info on projected nodes
+	Node_Info *get_node_info()
+	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Node_Info);
+#endif
+		return &this->info;
+	}
+
+	/*
+	 * The field is faulted in before it is written, otherwise a projected
+	 * node would get the value of its file back in xml_create().
+	 */
+	void set_name(std::string_view value)
+	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Name);
+#endif
+		this->info.set_name(value);
+		this->set_modified();
+	}
+
+	void set_info(std::string_view value)
+	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Info);
+#endif
+		this->info.set_info(value);
+		this->set_modified();
+	}
+
+	void set_memo(std::string_view value)
+	{
+#ifdef _XML_SUPPORT
+		this->xml_fault_in(Node_Fields::Memo);
+#endif
+		this->info.set_memo(value);
+		this->set_modified();
+	}
+
 	 /* if is listing item, then return >0
 	  * if not, then <=0
 	  */
@@ -156,47 +221,59 @@ public:
 	std::string xml_get(XML_Options_Table &options)
 	{
 		tinyxml2::XMLPrinter printer;
-		this->xml_create(&printer, options);
-
-#ifdef _ZLIB
-
-		if(options.compress_node)
-		{
-			std::string buffer = printer.CStr();
-			printer.ClearBuffer();
-
-			xml_string_compress_print(buffer, &printer, options);
-		}
-
-#endif
+		this->xml_get(&printer, options);
 
 		return std::string(printer.CStr());
 	}
 
 	void xml_get(tinyxml2::XMLPrinter *printer, XML_Options_Table &options)
 	{
-#ifdef _ZLIB
+		this->xml_get(printer, options, nullptr);
+	}
+
+	/*
+	 * With compress_node the node is compressed with zstd, when the
+	 * dictionary is given (_ZSTD), else with zlib (_ZLIB).
+	 */
+	void xml_get(tinyxml2::XMLPrinter *printer, XML_Options_Table &options, Zstd_Dictionary *dictionary)
+	{
+#ifndef _ZSTD
+		// Only used by zstd
+		if(dictionary != nullptr)
+		{
+		}
+#endif
+
+#if defined(_ZLIB) || defined(_ZSTD)
 
 		if(options.compress_node)
 		{
 			tinyxml2::XMLPrinter printer_t;
 			this->xml_create(&printer_t, options);
 
-			xml_string_compress_print(printer_t.CStr(), printer, options);
-		}
+			std::string_view xml(printer_t.CStr(), printer_t.CStrSize() - 1);
 
-		else
-		{
+#ifdef _ZSTD
+			if(xml_zstd_compress_print(xml, printer, options, dictionary) == EXIT_SUCCESS)
+			{
+				return void();
+			}
 #endif
-			this->xml_create(printer, options);
+
 #ifdef _ZLIB
+			xml_zlib_compress_print(xml, printer, options);
+			return void();
+#endif
 		}
 
 #endif
+		this->xml_create(printer, options);
 	}
 
 	virtual void xml_create(tinyxml2::XMLPrinter *printer, XML_Options_Table &options)
 	{
+		this->xml_fault_in(Node_Fields::All);
+
 		printer->OpenElement(this->xml_name.c_str(), options.no_empty_space);
 
 		this->xml_print_privateID(printer, options);
@@ -270,6 +347,12 @@ public:
 			return EXIT_SUCCESS;
 		}
 
+		else if(name == XML_STRING_PRIVATE XML_STRING_ID XML_STRING_VARINT)
+		{
+			this->privateID = varint_read<Type_ID>(element);
+			return EXIT_SUCCESS;
+		}
+
 		return EXIT_FAILURE;
 	}
 
@@ -280,8 +363,18 @@ public:
 			return void();
 		}
 
+		/*
+		 * With _XML_COMPACT_ID the privateID is written as a varint,
+		 * on its own element, so older readers are not confused.
+		 * Both of the forms are always read.
+		 */
+#ifdef _XML_COMPACT_ID
+		printer->OpenElement(XML_STRING_PRIVATE XML_STRING_ID XML_STRING_VARINT, options.no_empty_space);
+		varint_write<Type_ID>(this->privateID, printer);
+#else
 		printer->OpenElement(XML_STRING_PRIVATE XML_STRING_ID, options.no_empty_space);
 		variable_write<Type_ID>(this->privateID, printer);
+#endif
 		printer->CloseElement(options.no_empty_space);
 	}
 
@@ -314,10 +407,193 @@ public:
 		return EXIT_SUCCESS;
 	}
 
+	// True, when T or a class between has its own xml_parse_loop()
+	static constexpr bool xml_parse_loop_replaced()
+	{
+		return std::is_same<decltype(&T::xml_parse_loop), int (Node<T>::*)(tinyxml2::XMLElement*)>::value == false;
+	}
+
+	/*
+	 * Same as xml_parse_loop(), but loads only the Node_Fields given in fields.
+	 * The skipped child elements are printed to a new text and parsed later by
+	 * xml_fault_in(). Derived classes that replace xml_parse_loop() keep source,
+	 * the text element was parsed from, as it is instead, they should be loaded
+	 * with Node_Fields::All anyway. The others call
+	 * xml_fault_in(Node_Fields::Values) before they use or change their values.
+	 */
+	int xml_parse_loop_projected(tinyxml2::XMLElement *element, unsigned int fields, std::string_view source = std::string_view())
+	{
+		if(fields == Node_Fields::All)
+		{
+			return this->xml_parse_loop(element);
+		}
+
+		if(element == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
+
+		if(element->Value() != this->xml_name)
+		{
+			return EXIT_FAILURE;
+		}
+
+		bool keep_source = source.empty() == false && Node<T>::xml_parse_loop_replaced();
+		bool skipped = false;
+
+		tinyxml2::XMLPrinter deferred(nullptr, true);
+		tinyxml2::XMLElement *element_child = element->FirstChildElement();
+
+		if(keep_source == false)
+		{
+			deferred.OpenElement(element->Value(), true);
+		}
+
+		while(element_child != nullptr)
+		{
+			if(this->xml_parse_privateID(element_child) == EXIT_SUCCESS)
+			{
+				element_child = element_child->NextSiblingElement();
+				continue;
+			}
+
+			if(this->info.xml_parse(element_child, fields) == EXIT_SUCCESS)
+			{
+				if((fields & Node_Fields::Node_Info) != Node_Fields::Node_Info && keep_source == false)
+				{
+					element_child->Accept(&deferred);
+					skipped = true;
+				}
+			}
+
+			else
+			{
+				this->flags.xml_flags_read(element_child);
+
+				if(fields & Node_Fields::Values)
+				{
+					this->xml_values_read(element_child);
+				}
+
+				else if(keep_source == false)
+				{
+					element_child->Accept(&deferred);
+					skipped = true;
+				}
+			}
+
+			element_child = element_child->NextSiblingElement();
+		}
+
+		this->xml_fields_loaded = fields & Node_Fields::All;
+
+		if(keep_source)
+		{
+			this->xml_deferred.assign(source.data(), source.size());
+		}
+
+		// Nothing to parse later, when no child has been skipped
+		else if(skipped)
+		{
+			deferred.CloseElement(true);
+			this->xml_deferred = deferred.CStr();
+		}
+
+		else
+		{
+			this->xml_deferred.clear();
+		}
+
+		return EXIT_SUCCESS;
+	}
+
+	/*
+	 * Parses the fields left out by xml_parse_loop_projected(), if any of the
+	 * given fields is still missing.
+	 */
+	void xml_fault_in(unsigned int fields)
+	{
+		unsigned int missing = fields & ~this->xml_fields_loaded & Node_Fields::All;
+
+		if(missing == 0)
+		{
+			return void();
+		}
+
+		if(this->xml_deferred.empty() == false)
+		{
+			tinyxml2::XMLDocument document;
+			document.Parse(this->xml_deferred.c_str(), this->xml_deferred.size());
+			tinyxml2::XMLElement *element = document.RootElement();
+			element = element != nullptr ? element->FirstChildElement() : nullptr;
+
+			while(element != nullptr)
+			{
+				// The privateID may have been changed since
+				if(std::strcmp(element->Value(), XML_STRING_PRIVATE XML_STRING_ID) != 0 &&
+						std::strcmp(element->Value(), XML_STRING_PRIVATE XML_STRING_ID XML_STRING_VARINT) != 0 &&
+						this->info.xml_parse(element, missing) == EXIT_FAILURE &&
+						(missing & Node_Fields::Values))
+				{
+					this->xml_values_read(element);
+				}
+
+				element = element->NextSiblingElement();
+			}
+		}
+
+		this->xml_fields_loaded |= missing;
+
+		if(this->xml_fields_loaded == Node_Fields::All)
+		{
+			this->xml_deferred.clear();
+			this->xml_deferred.shrink_to_fit();
+		}
+	}
+
+	bool xml_is_loaded(unsigned int fields)
+	{
+		return (this->xml_fields_loaded & fields) == fields;
+	}
+
+	/*
+	 * Base64 encoded privateID, used on the file names.
+	 * Encoded again only when the privateID has changed.
+	 */
+	const char *get_encoded_privateID()
+	{
+		if(this->xml_encoded_privateID[0] == '\0' || this->xml_encoded_for != this->privateID)
+		{
+			unsigned char raw[sizeof(Type_ID)];
+			std::memcpy(raw, &this->privateID, sizeof(Type_ID));
+
+			size_t size = base64Encode(raw, sizeof(Type_ID), this->xml_encoded_privateID);
+			this->xml_encoded_privateID[size] = '\0';
+			this->xml_encoded_for = this->privateID;
+		}
+
+		return this->xml_encoded_privateID;
+	}
+
 	void xml_set_node_infos(std::string node_name)
+	{
+#ifdef _NODE_INFO_COMPACT
+		if(this->xml_name != node_name)
+		{
+			String_Pool *pool = this->info.pool != nullptr ? this->info.pool : String_Pool::get_default();
+			this->xml_name = pool->intern(node_name);
+		}
+#else
+		this->xml_name = node_name;
+#endif
+	}
+
+#ifdef _NODE_INFO_COMPACT
+	void xml_set_node_infos(const Interned_String &node_name)
 	{
 		this->xml_name = node_name;
 	}
+#endif
 
 #endif
 
@@ -327,13 +603,132 @@ public:
 		this->id = 0;
 		this->sqlID = 0;
 		this->node_flags.flags_clear();
+		this->pins = 0;
 		this->info.clear();
+		this->set_modified();
 #ifdef _XML_SUPPORT
 		this->xml_name.clear();
+#ifndef _NODE_INFO_COMPACT
 		this->xml_name.shrink_to_fit();
+#endif
+		this->xml_fields_loaded = Node_Fields::All;
+		this->xml_encoded_privateID[0] = '\0';
+		this->xml_encoded_for = 0;
+		this->xml_deferred.clear();
+		this->xml_deferred.shrink_to_fit();
 #endif
 	}
 
+	/*
+	 * Has to be called after the node is changed, when snapshots or the
+	 * memory budget of the manager are used. Snapshots copy the node
+	 * again only after this, the budget saves the node before evicting it.
+	 * The set_ functions of the node and of its Node_Info do it, changes
+	 * of flags and of the fields of derived classes have to call it.
+	 */
+	void set_modified()
+	{
+		this->modified_stamp = Node<T>::modified_stamp_next();
+	}
+
+	// Latest stamp of the node and of its Node_Info
+	uint64_t get_modified_stamp() const
+	{
+		return this->modified_stamp > this->info.modified_stamp ? this->modified_stamp : this->info.modified_stamp;
+	}
+
+	// Stamps are unique over all nodes, also over deleted ones
+	static uint64_t modified_stamp_next()
+	{
+		return node_modified_stamp_next();
+	}
+
+	/*
+	 * Bytes of the node in memory, for the memory budget of the manager.
+	 * Nodes owning more memory add theirs to this.
+	 */
+	virtual size_t memory_size() const
+	{
+		size_t size = sizeof(T) + this->info.memory_size();
+#ifdef _XML_SUPPORT
+		size += string_memory_size(this->xml_name) + string_memory_size(this->xml_deferred);
+#endif
+		return size;
+	}
+
+	/*
+	 * Called on a node just read from its file, when the manager has a
+	 * prefetch depth. Nodes with depencies call Node_Depency::prefetch()
+	 * for them with depth, so their files are read in the background.
+	 */
+	virtual void depency_prefetch(unsigned int depth)
+	{
+		if(depth != 0)
+		{
+			return void();
+		}
+	}
+
+	/*
+	 * Called by Manager::depency_batch_collect(). Nodes with depencies
+	 * call Node_Depency::collect() for them with the manager of the target
+	 * and this node as the owner.
+	 */
+	virtual void depency_collect()
+	{
+
+	}
+
+	/*
+	 * Copy of the node for the snapshots of the manager. Nodes, which
+	 * own memory through raw pointers, have to give a deep copy here.
+	 */
+	virtual T *snapshot_clone() const
+	{
+		return new T(*static_cast<const T*>(this));
+	}
+
+	/*
+	 * Called on the copy made by snapshot_clone(), which must not point
+	 * into the live manager. Nodes with depencies call
+	 * Node_Depency::snapshot_detach() for them, the targets are then
+	 * found by privateID from the snapshot of their manager.
+	 */
+	virtual void snapshot_detach()
+	{
+
+	}
+
+	/*
+	 * Takes over the variables of the Node level from the other node,
+	 * the strings and buffers are moved, not copied. The list pointers
+	 * are not touched, from is left cleared.
+	 */
+	void move_node_variables_from(Node<T> *from)
+	{
+		if(from == this)
+		{
+			return void();
+		}
+
+		this->privateID = from->privateID;
+		this->id = from->id;
+		this->sqlID = from->sqlID;
+		this->node_flags = from->node_flags;
+		this->flags = from->flags;
+		this->info.move_from(&from->info);
+#ifdef _XML_SUPPORT
+		this->xml_name = std::move(from->xml_name);
+		this->xml_fields_loaded = from->xml_fields_loaded;
+		this->xml_deferred = std::move(from->xml_deferred);
+		std::memcpy(this->xml_encoded_privateID, from->xml_encoded_privateID, sizeof(this->xml_encoded_privateID));
+		this->xml_encoded_for = from->xml_encoded_for;
+#endif
+
+		this->set_modified();
+		from->clear_node_variables();
+	}
+
 	virtual int sync(Sync_Table &table)
 	{
 		if(table.dataFiles_read)
@@ -403,18 +798,37 @@ public:
 	Type_ID id;
 	Type_ID privateID;
 	Type_ID sqlID;
+	uint64_t modified_stamp;
 	_BitField node_flags;
+
+	/*
+	 * Held while get_pointer_of_privateID() syncs the node and while its
+	 * depencies wait in a batch, the manager does not evict or delete
+	 * pinned nodes.
+	 */
+	unsigned int pins;
 	_BitField flags;
 
 
 	T *prev;
 	T *next;
 
+	/*
+	 * On nodes loaded with a Node_Load_Options projection, the fields may
+	 * not be parsed yet. Use get_node_info() or the get_ and set_ functions
+	 * of the node then, or call xml_fault_in() before info is accessed.
+	 */
 	Node_Info info;
 
 #ifdef _XML_SUPPORT
 protected:
-	std::string xml_name;
+	Node_Info_String xml_name;
+
+	unsigned int xml_fields_loaded;
+	std::string xml_deferred;
+
+	char xml_encoded_privateID[XML_ENCODED_PRIVATEID_SIZE];
+	Type_ID xml_encoded_for;
 #endif
 
 };
@@ -180,6 +180,73 @@ struct Node_Depency
 
 	}
 
+	// Queues an asynchronous read of the target, when it is not resolved yet
+	void prefetch(M *manager, unsigned int depth)
+	{
+		Type_ID id = this->new_privateID != 0 ? this->new_privateID : this->privateID;
+
+		if(manager != nullptr && id != 0 && this->node == nullptr)
+		{
+			manager->prefetch(id, depth);
+		}
+	}
+
+	/*
+	 * Queues the depency in the batch of manager, when sync_node_depency()
+	 * would look it up, see Manager::depency_batch_resolve(). owner is the
+	 * node having the depency, it is pinned until the batch is resolved.
+	 */
+	template <class O>
+	void collect(M *manager, O *owner)
+	{
+		Type_ID id = this->new_privateID != 0 ? this->new_privateID : this->privateID;
+
+		if(manager != nullptr && id != 0 && this->give_up == false && (this->node == nullptr || this->changed))
+		{
+			manager->depency_batch_add(id, owner != nullptr ? &owner->pins : nullptr, [this](N *node)
+			{
+				this->resolve(node);
+			});
+		}
+	}
+
+	// Takes new_node as the target, gives up on nullptr
+	void resolve(N *new_node)
+	{
+		if(new_node == nullptr)
+		{
+			this->give_up = true;
+			return void();
+		}
+
+		/*
+		 * This whole class (Node_Depency) is a litle bit glichy,
+		 * we wil need to set privateID from new_node.
+		 *
+		 * Don't ask me why, maby a glich on the C++ generator
+		 */
+		this->privateID = new_node->privateID;
+		this->new_privateID = 0;
+
+		if(this->node != nullptr)
+		{
+			this->node->node_flags.bit_set(Node_Flags::Needed, false);
+		}
+
+		this->node = new_node;
+		this->node_synched = true;
+		this->node->node_flags.bit_set(Node_Flags::Needed, true);
+		this->changed = false;
+	}
+
+	// Forgets the node, but keeps its privateID, for the copies of snapshots
+	void snapshot_detach()
+	{
+		this->node = nullptr;
+		this->node_synched = false;
+		this->synched = false;
+	}
+
 	void copy_from(Node_Depency *from)
 	{
 		this->privateID = from->privateID;
@@ -296,7 +363,10 @@ int sync_node_depency(M *manager, Node_Depency<M, N> &nodeDepency,  Sync_Table &
 		return EXIT_FAILURE;
 	}
 
-	if((nodeDepency.synched == false && nodeDepency.give_up == false) || (nodeDepency.changed && nodeDepency.give_up == false) || table.resync)
+	// Already resolved by Manager::depency_batch_resolve()
+	bool resolved = nodeDepency.node != nullptr && nodeDepency.node_synched && nodeDepency.changed == false && table.resync == false;
+
+	if(((nodeDepency.synched == false && nodeDepency.give_up == false) || (nodeDepency.changed && nodeDepency.give_up == false) || table.resync) && resolved == false)
 	{
 		N *new_node = nullptr;
 
@@ -312,28 +382,10 @@ int sync_node_depency(M *manager, Node_Depency<M, N> &nodeDepency,  Sync_Table &
 
 		if(new_node != nullptr)
 		{
-			/*
-			 * This whole class (Node_Depency) is a litle bit glichy,
-			 * we wil need to set privateID from new_node.
-			 *
-			 * Don't ask me why, maby a glich on the C++ generator
-			 */
-			nodeDepency.privateID = new_node->privateID;
-			nodeDepency.new_privateID = 0;
-
-			if(nodeDepency.node != nullptr)
-			{
-				nodeDepency.node->node_flags.bit_set(Node_Flags::Needed, false);
-			}
-
-			nodeDepency.node = new_node;
-			nodeDepency.node_synched = true;
-			nodeDepency.node->node_flags.bit_set(Node_Flags::Needed, true);
-			nodeDepency.changed = false;
-
+			nodeDepency.resolve(new_node);
 
 #ifdef _DEBUG
-			std::cout << "name : " << nodeDepency.node->info.name << std::endl;
+			std::cout << "name : " << std::string_view(nodeDepency.node->info.name) << std::endl;
 #endif
 		}
 
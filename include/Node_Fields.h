@@ -0,0 +1,79 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Node_Fields.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __NODE_FIELDS
+#define __NODE_FIELDS
+
+/*
+ * Node_Fields selects which parts of a node are materialized when the
+ * node is parsed. Parts that are left out stay as unparsed XML inside the
+ * node and are faulted in on first access, see Node::xml_fault_in().
+ *
+ * privateID and flags are always read, they are small and needed
+ * for the bookkeeping of the manager.
+ */
+namespace Node_Fields
+{
+	enum Field : unsigned int
+	{
+		None = 0,
+		Name = 1 << 0,
+		Info = 1 << 1,
+		Memo = 1 << 2,
+		Values = 1 << 3,
+
+		Node_Info = Name | Info | Memo,
+		All = Name | Info | Memo | Values
+	};
+}
+
+/*
+ * Options for Manager::load_file() and Manager::xml_node_parse()
+ * fields : mask of Node_Fields to load, Node_Fields::All by default
+ */
+struct Node_Load_Options
+{
+	unsigned int fields;
+
+	Node_Load_Options()
+	{
+		this->fields = Node_Fields::All;
+	}
+
+	Node_Load_Options(unsigned int load_fields)
+	{
+		this->fields = load_fields;
+	}
+};
+#endif
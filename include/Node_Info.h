@@ -37,8 +37,37 @@
 
 #include <Common_Types.h>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <Node_Fields.h>
+
+#ifdef _NODE_INFO_COMPACT
+#include <String_Pool.h>
+#endif
 
 struct Sync_Table;
+
+/*
+ * With _NODE_INFO_COMPACT the strings are interned to a String_Pool,
+ * equal names of the nodes of one manager share their storage.
+ * The set_ functions work in both of the modes.
+ */
+#ifdef _NODE_INFO_COMPACT
+typedef Interned_String Node_Info_String;
+#else
+typedef std::string Node_Info_String;
+#endif
+
+// Stamps of the changes of the nodes, unique over all nodes of all types
+uint64_t node_modified_stamp_next();
+
+// Heap memory of the string, short strings inside the object have none
+size_t string_memory_size(const std::string &value);
+#ifdef _NODE_INFO_COMPACT
+// The data may be shared in the pool, it is counted for every user
+size_t string_memory_size(const Interned_String &value);
+#endif
+
 /*
  * Node_Info table contains some information of the node,
  * priveteID : unique identification of the node
@@ -50,14 +79,29 @@ struct Sync_Table;
 
 struct Node_Info
 {
-	std::string name;
-	std::string info;
-	std::string memo;
+	Node_Info_String name;
+	Node_Info_String info;
+	Node_Info_String memo;
+#ifdef _NODE_INFO_COMPACT
+	// nullptr uses String_Pool::get_default()
+	String_Pool *pool = nullptr;
+#endif
+	// Set by the functions changing the strings, see Node::get_modified_stamp()
+	uint64_t modified_stamp = 0;
+
+	void set_name(std::string_view value);
+	void set_info(std::string_view value);
+	void set_memo(std::string_view value);
 
 	void clear();
 	void copy_to(Node_Info *to);
 	void copy_from(Node_Info *from);
-	int xml_parse(tinyxml2::XMLElement *element);
+	// Like copy_, but the strings are taken over and the source is left empty
+	void move_to(Node_Info *to);
+	void move_from(Node_Info *from);
+	// Heap memory of the strings
+	size_t memory_size() const;
+	int xml_parse(tinyxml2::XMLElement *element, unsigned int fields = Node_Fields::All);
 	void xml_create(tinyxml2::XMLPrinter *printer, XML_Options_Table &options);
 };
 #endif
@@ -0,0 +1,152 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/String_Pool.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __STRING_POOL
+#define __STRING_POOL
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+class String_Pool;
+struct String_Pool_Storage;
+
+/*
+ * The pool holds one of the references of each of its entries, so the
+ * count gets to 0 only after the pool is gone.
+ */
+struct String_Pool_Entry
+{
+	std::atomic<uint32_t> references;
+	uint32_t size;
+	String_Pool_Storage *storage;
+	char data[1];
+};
+
+/*
+ * Reference to a string of a String_Pool, the size of one pointer.
+ * Equal strings of the same pool share one entry, so comparing them
+ * is a pointer compare. The text is null terminated. The memory of the
+ * pool is kept until its last Interned_String is gone, so they may
+ * outlive the pool.
+ */
+class Interned_String
+{
+public:
+	Interned_String();
+	Interned_String(const Interned_String &other);
+	Interned_String(Interned_String &&other) noexcept;
+	~Interned_String();
+
+	Interned_String &operator=(const Interned_String &other);
+	Interned_String &operator=(Interned_String &&other) noexcept;
+
+	const char *c_str() const;
+	const char *data() const;
+	size_t size() const;
+	bool empty() const;
+	void clear();
+
+	std::string_view view() const;
+	operator std::string_view() const;
+
+	bool operator==(const Interned_String &other) const;
+	bool operator!=(const Interned_String &other) const;
+
+private:
+	friend class String_Pool;
+
+	// Takes over a reference, which is already counted
+	explicit Interned_String(String_Pool_Entry *entry);
+
+	String_Pool_Entry *entry;
+};
+
+bool operator==(const Interned_String &a, std::string_view b);
+bool operator==(std::string_view a, const Interned_String &b);
+bool operator!=(const Interned_String &a, std::string_view b);
+bool operator!=(std::string_view a, const Interned_String &b);
+
+/*
+ * Interner of strings, entries are allocated from blocks of block_size
+ * bytes. An entry is not freed when its last reference goes away,
+ * collect() frees those and their space is reused for new entries of
+ * the same size class. collect_needed() is cheap enough to call after
+ * each change, it collects only when the unreferenced entries add up. intern() and collect() are thread safe,
+ * Interned_Strings can be copied and released from any thread.
+ */
+class String_Pool
+{
+public:
+	String_Pool(size_t block_size = 65536);
+	~String_Pool();
+
+	String_Pool(const String_Pool &) = delete;
+	String_Pool &operator=(const String_Pool &) = delete;
+
+	Interned_String intern(std::string_view value);
+
+	// Frees the entries without references, returns the count of freed bytes
+	size_t collect();
+	// collect(), once enough entries have lost their last reference
+	size_t collect_needed();
+
+	size_t get_count();
+	// Bytes of the blocks and of the large entries, without the table
+	size_t get_memory();
+
+	// Pool of strings, which have no pool of their own
+	static String_Pool *get_default();
+
+private:
+	void *allocate(size_t size);
+	void release(String_Pool_Entry *entry);
+	size_t collect_locked();
+
+	std::mutex mutex;
+	std::unordered_map<std::string_view, String_Pool_Entry*> table;
+	// Blocks, shared with the entries still referenced
+	String_Pool_Storage *storage;
+	std::vector<std::vector<void*>> free_lists;
+	char *block_position;
+	size_t block_left;
+	size_t block_size;
+	size_t memory;
+};
+#endif
@@ -0,0 +1,100 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/include/Text_Index.h
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef __TEXT_INDEX
+#define __TEXT_INDEX
+
+#include <Common_Types.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+#include <functional>
+
+// Longer terms are cut to this many bytes
+#ifndef TEXT_INDEX_TERM_MAX_SIZE
+#define TEXT_INDEX_TERM_MAX_SIZE 64
+#endif
+
+/*
+ * Inverted index of free text, terms to the sorted privateIDs of the
+ * nodes having them. Terms are runs of letters and digits, ASCII is
+ * lower cased and other UTF-8 bytes are kept as they are.
+ *
+ * The file has the posting lists as varint deltas. Changes after it are
+ * appended to a journal file next to it, file_write() merges them.
+ */
+class Text_Index
+{
+public:
+	Text_Index();
+
+	void clear();
+
+	// Replaces the terms of the node
+	void update(Type_ID privateID, std::initializer_list<std::string_view> texts);
+	void remove(Type_ID privateID);
+
+	// privateIDs having all of the terms of query, sorted
+	std::vector<Type_ID> search(std::string_view query) const;
+
+	size_t get_term_count() const;
+	size_t get_document_count() const;
+
+	// Reads the index and replays its journal
+	int file_read(const std::string &path);
+	// Whole index, the journal is removed
+	int file_write(const std::string &path);
+	// Appends the changes since the last read or write to the journal
+	int file_update(const std::string &path);
+
+	static void tokenize(std::string_view text, const std::function<void(std::string_view term)> &callback);
+
+private:
+	void add_terms(Type_ID privateID, std::vector<std::string> &terms);
+	void remove_terms(Type_ID privateID);
+	int journal_replay(const std::vector<unsigned char> &data);
+
+	std::unordered_map<std::string, std::vector<Type_ID>> postings;
+	// Keys of postings, for removing the terms of a node
+	std::unordered_map<Type_ID, std::vector<const std::string*>> documents;
+
+	// Records not yet appended to the journal file
+	std::vector<unsigned char> journal;
+	size_t file_size;
+	size_t journal_file_size;
+};
+
+#endif
@@ -1,8 +1,16 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <type_convert.h>
 
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
 template <typename Vec_T, typename Variable_T>
 bool glm_pop_back(std::vector<unsigned char> &buffer, Vec_T &vec, uint64_t &offset)
 {
@@ -29,12 +37,85 @@ void glm_push_back(std::vector<unsigned char> &buffer, Vec_T &vec)
   }
 }
 
+// Count of the scalar components of a glm vector, quaternion or matrix
 template <typename Vec_T>
-bool glm_is_empty(Vec_T table)
+constexpr size_t glm_component_count()
 {
-  for(int i = 0; i < table.length(); i++)
+  return sizeof(Vec_T) / sizeof(typename Vec_T::value_type);
+}
+
+/*
+ * Array versions of glm_push_back() and glm_pop_back(), the components
+ * are copied with one memcpy in the same layout as glm_push_back() with
+ * Variable_T being the value_type of Vec_T. The count is not stored,
+ * see view_pop_back().
+ */
+template <typename Vec_T>
+void glm_array_push_back(std::vector<unsigned char> &buffer, const Vec_T *source, size_t count, bool little_endian = false)
+{
+  typedef typename Vec_T::value_type Value_T;
+  static_assert(sizeof(Vec_T) == glm_component_count<Vec_T>() * sizeof(Value_T), "Vec_T has to be tightly packed");
+
+  if(count == 0)
   {
-    if(table[i] != 0.0f)
+    return void();
+  }
+
+  size_t offset = buffer.size();
+  buffer.resize(offset + count * sizeof(Vec_T));
+
+  array_to_uchar<Value_T>(glm::value_ptr(source[0]), count * glm_component_count<Vec_T>(), buffer.data() + offset, little_endian);
+}
+
+template <typename Vec_T>
+void glm_array_push_back(std::vector<unsigned char> &buffer, const std::vector<Vec_T> &source, bool little_endian = false)
+{
+  glm_array_push_back<Vec_T>(buffer, source.data(), source.size(), little_endian);
+}
+
+// Replaces the content of table with count values
+template <typename Vec_T>
+bool glm_array_pop_back(std::vector<unsigned char> &buffer, std::vector<Vec_T> &table, uint64_t count, uint64_t &offset, bool little_endian = false)
+{
+  typedef typename Vec_T::value_type Value_T;
+
+  if(offset > buffer.size() || count > (buffer.size() - offset) / sizeof(Vec_T))
+  {
+    return EXIT_FAILURE;
+  }
+
+  table.resize(count);
+
+  if(count > 0)
+  {
+    uchar_to_array<Value_T>(buffer.data() + offset, count * sizeof(Vec_T), glm::value_ptr(table[0]), little_endian);
+  }
+
+  offset += count * sizeof(Vec_T);
+  return EXIT_SUCCESS;
+}
+
+/*
+ * Checks over the flattened components. The inner loops have no branches
+ * so that compilers vectorize them, the result is checked once per block.
+ * They rely on IEEE compares, so they do not work with -ffast-math.
+ */
+#define GLM_CHECK_BLOCK 1024
+
+template <typename Value_T>
+bool glm_values_is_empty(const Value_T *values, size_t count)
+{
+  for(size_t block = 0; block < count; block += GLM_CHECK_BLOCK)
+  {
+    size_t end = std::min(count, block + GLM_CHECK_BLOCK);
+    unsigned int found = 0;
+
+    for(size_t i = block; i < end; i++)
+    {
+      found |= (values[i] != Value_T(0));
+    }
+
+    if(found != 0)
     {
       return false;
     }
@@ -43,12 +124,44 @@ bool glm_is_empty(Vec_T table)
   return true;
 }
 
-template <typename Vec_T>
-bool glm_is_all_numeric(Vec_T table)
+// False when any of the values is NaN
+template <typename Value_T>
+bool glm_values_is_all_numeric(const Value_T *values, size_t count)
+{
+  for(size_t block = 0; block < count; block += GLM_CHECK_BLOCK)
+  {
+    size_t end = std::min(count, block + GLM_CHECK_BLOCK);
+    unsigned int found = 0;
+
+    for(size_t i = block; i < end; i++)
+    {
+      found |= (values[i] != values[i]);
+    }
+
+    if(found != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// False when any of the values is NaN or infinite, x - x is NaN for both of them
+template <typename Value_T>
+bool glm_values_is_all_finite(const Value_T *values, size_t count)
 {
-  for(int i = 0; i < table.length(); i++)
+  for(size_t block = 0; block < count; block += GLM_CHECK_BLOCK)
   {
-    if(std::isnan(table[i].x) == true)
+    size_t end = std::min(count, block + GLM_CHECK_BLOCK);
+    unsigned int found = 0;
+
+    for(size_t i = block; i < end; i++)
+    {
+      found |= ((values[i] - values[i]) != Value_T(0));
+    }
+
+    if(found != 0)
     {
       return false;
     }
@@ -56,3 +169,362 @@ bool glm_is_all_numeric(Vec_T table)
 
   return true;
 }
+
+template <typename Vec_T>
+bool glm_is_empty(const Vec_T &table)
+{
+  return glm_values_is_empty(glm::value_ptr(table), glm_component_count<Vec_T>());
+}
+
+template <typename Vec_T>
+bool glm_is_all_numeric(const Vec_T &table)
+{
+  return glm_values_is_all_numeric(glm::value_ptr(table), glm_component_count<Vec_T>());
+}
+
+template <typename Vec_T>
+bool glm_is_all_finite(const Vec_T &table)
+{
+  return glm_values_is_all_finite(glm::value_ptr(table), glm_component_count<Vec_T>());
+}
+
+template <typename Vec_T>
+bool glm_array_is_empty(const std::vector<Vec_T> &table)
+{
+  return table.empty() || glm_values_is_empty(glm::value_ptr(table[0]), table.size() * glm_component_count<Vec_T>());
+}
+
+template <typename Vec_T>
+bool glm_array_is_all_numeric(const std::vector<Vec_T> &table)
+{
+  return table.empty() || glm_values_is_all_numeric(glm::value_ptr(table[0]), table.size() * glm_component_count<Vec_T>());
+}
+
+template <typename Vec_T>
+bool glm_array_is_all_finite(const std::vector<Vec_T> &table)
+{
+  return table.empty() || glm_values_is_all_finite(glm::value_ptr(table[0]), table.size() * glm_component_count<Vec_T>());
+}
+
+/*
+ * Quantized encodings, for data which does not need full floats. The batch
+ * versions work on plain arrays, their loops have no branches so that
+ * compilers vectorize them. The encoded arrays can be stored with
+ * vectorType_to_vectorUChar() or array_write().
+ */
+
+// Half floats, relative error at most 2^-11 above 2^-14, largest value 65504
+#define GLM_HALF_RELATIVE_ERROR (1.0f / 2048.0f)
+
+inline uint16_t float_to_half(float value)
+{
+  const uint32_t denormal_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+  uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+
+  uint32_t sign = x & 0x80000000u;
+  x ^= sign;
+
+  // Results below the normal range, the add rounds the low bits away
+  float denormal_float;
+  float magic_float;
+  std::memcpy(&denormal_float, &x, sizeof(x));
+  std::memcpy(&magic_float, &denormal_magic, sizeof(x));
+  denormal_float += magic_float;
+
+  uint32_t denormal;
+  std::memcpy(&denormal, &denormal_float, sizeof(x));
+  denormal -= denormal_magic;
+
+  // Round to nearest even
+  uint32_t normal = (x - (112u << 23) + 0xfffu + ((x >> 13) & 1u)) >> 13;
+  uint32_t special = x > 0x7f800000u ? 0x7e00u : 0x7c00u;
+
+  uint32_t result = x >= (143u << 23) ? special : (x < (113u << 23) ? denormal : normal);
+
+  return uint16_t((sign >> 16) | result);
+}
+
+inline float half_to_float(uint16_t half)
+{
+  const uint32_t shifted_exponent = 0x7c00u << 13;
+  const uint32_t magic = 113u << 23;
+
+  uint32_t x = uint32_t(half & 0x7fffu) << 13;
+  uint32_t exponent = x & shifted_exponent;
+  x += (127u - 15u) << 23;
+
+  uint32_t special = x + ((128u - 16u) << 23);
+
+  uint32_t denormal = x + (1u << 23);
+  float denormal_float;
+  float magic_float;
+  std::memcpy(&denormal_float, &denormal, sizeof(x));
+  std::memcpy(&magic_float, &magic, sizeof(x));
+  denormal_float -= magic_float;
+  std::memcpy(&denormal, &denormal_float, sizeof(x));
+
+  x = exponent == shifted_exponent ? special : (exponent == 0 ? denormal : x);
+  x |= uint32_t(half & 0x8000u) << 16;
+
+  float value;
+  std::memcpy(&value, &x, sizeof(x));
+
+  return value;
+}
+
+inline void half_encode_batch(const float *source, size_t count, uint16_t *target)
+{
+  size_t i = 0;
+
+#ifdef __F16C__
+  for(; i + 8 <= count; i += 8)
+  {
+    __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128((__m128i*)(target + i), half);
+  }
+#endif
+
+  for(; i < count; i++)
+  {
+    target[i] = float_to_half(source[i]);
+  }
+}
+
+inline void half_decode_batch(const uint16_t *source, size_t count, float *target)
+{
+  size_t i = 0;
+
+#ifdef __F16C__
+  for(; i + 8 <= count; i += 8)
+  {
+    __m128i half = _mm_loadu_si128((const __m128i*)(source + i));
+    _mm256_storeu_ps(target + i, _mm256_cvtph_ps(half));
+  }
+#endif
+
+  for(; i < count; i++)
+  {
+    target[i] = half_to_float(source[i]);
+  }
+}
+
+// Every float component of count glm values, target holds count * glm_component_count<Vec_T>()
+template <typename Vec_T>
+void glm_half_encode(const Vec_T *source, size_t count, uint16_t *target)
+{
+  if(count > 0)
+  {
+    half_encode_batch(glm::value_ptr(source[0]), count * glm_component_count<Vec_T>(), target);
+  }
+}
+
+template <typename Vec_T>
+void glm_half_decode(const uint16_t *source, size_t count, Vec_T *target)
+{
+  if(count > 0)
+  {
+    half_decode_batch(source, count * glm_component_count<Vec_T>(), glm::value_ptr(target[0]));
+  }
+}
+
+/*
+ * Unit vectors as two 16 bit components of the octahedral projection,
+ * packed x to the low half. The angle to the decoded vector is at most
+ * GLM_OCTAHEDRAL_ERROR radians.
+ */
+#define GLM_OCTAHEDRAL_ERROR 0.0001f
+
+inline void octahedral_encode_batch(const glm::vec3 *source, size_t count, uint32_t *target)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    float x = source[i][0];
+    float y = source[i][1];
+    float z = source[i][2];
+
+    float sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    float inverse = sum > 0.0f ? 1.0f / sum : 0.0f;
+
+    x *= inverse;
+    y *= inverse;
+
+    // Lower hemisphere is folded over the diagonals
+    float folded_x = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    float folded_y = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+    x = z < 0.0f ? folded_x : x;
+    y = z < 0.0f ? folded_y : y;
+
+    x = std::min(std::max(x, -1.0f), 1.0f) * 32767.0f;
+    y = std::min(std::max(y, -1.0f), 1.0f) * 32767.0f;
+
+    int16_t qx = int16_t(x + (x >= 0.0f ? 0.5f : -0.5f));
+    int16_t qy = int16_t(y + (y >= 0.0f ? 0.5f : -0.5f));
+
+    target[i] = uint32_t(uint16_t(qx)) | (uint32_t(uint16_t(qy)) << 16);
+  }
+}
+
+inline void octahedral_decode_batch(const uint32_t *source, size_t count, glm::vec3 *target)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    float x = float(int16_t(uint16_t(source[i] & 0xffffu))) * (1.0f / 32767.0f);
+    float y = float(int16_t(uint16_t(source[i] >> 16))) * (1.0f / 32767.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+    float fold = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -fold : fold;
+    y += y >= 0.0f ? -fold : fold;
+
+    float inverse = 1.0f / std::sqrt(x * x + y * y + z * z);
+
+    target[i][0] = x * inverse;
+    target[i][1] = y * inverse;
+    target[i][2] = z * inverse;
+  }
+}
+
+/*
+ * Unit quaternions with the smallest three components, 2 bits for the
+ * index of the dropped largest one and 20 bits for each of the others.
+ * q and -q are the same rotation, so the sign of the largest is dropped.
+ * Components are off by at most GLM_QUAT_COMPONENT_ERROR.
+ */
+#define GLM_QUAT_COMPONENT_ERROR 0.000002f
+
+template <typename Quat_T>
+void quat_encode_batch(const Quat_T *source, size_t count, uint64_t *target)
+{
+  const float range = 0.70710678f;
+  const float scale = 1048575.0f / (2.0f * range);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    float component[4] = {source[i][0], source[i][1], source[i][2], source[i][3]};
+    unsigned int largest = 0;
+
+    for(unsigned int j = 1; j < 4; j++)
+    {
+      largest = std::fabs(component[j]) > std::fabs(component[largest]) ? j : largest;
+    }
+
+    float sign = component[largest] < 0.0f ? -1.0f : 1.0f;
+    uint64_t packed = uint64_t(largest) << 60;
+    unsigned int shift = 40;
+
+    for(unsigned int j = 0; j < 4; j++)
+    {
+      if(j == largest)
+      {
+        continue;
+      }
+
+      float value = (component[j] * sign + range) * scale;
+      value = std::min(std::max(value, 0.0f), 1048575.0f);
+
+      packed |= uint64_t(uint32_t(value + 0.5f)) << shift;
+      shift -= 20;
+    }
+
+    target[i] = packed;
+  }
+}
+
+template <typename Quat_T>
+void quat_decode_batch(const uint64_t *source, size_t count, Quat_T *target)
+{
+  const float range = 0.70710678f;
+  const float scale = (2.0f * range) / 1048575.0f;
+
+  for(size_t i = 0; i < count; i++)
+  {
+    unsigned int largest = (unsigned int)(source[i] >> 60);
+    float component[4];
+    float sum = 0.0f;
+    unsigned int shift = 40;
+
+    for(unsigned int j = 0; j < 4; j++)
+    {
+      if(j == largest)
+      {
+        continue;
+      }
+
+      component[j] = float((source[i] >> shift) & 0xfffffu) * scale - range;
+      sum += component[j] * component[j];
+      shift -= 20;
+    }
+
+    component[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+
+    for(unsigned int j = 0; j < 4; j++)
+    {
+      target[i][j] = component[j];
+    }
+  }
+}
+
+/*
+ * Positions as 16 bit fixed point inside the box from minimum to maximum,
+ * 3 values for each position. Positions outside the box are clamped to it.
+ * The error is half of a step plus the rounding of the decoded floats.
+ */
+inline glm::vec3 aabb_quantize_error(const glm::vec3 &minimum, const glm::vec3 &maximum)
+{
+  glm::vec3 error;
+
+  for(int j = 0; j < 3; j++)
+  {
+    float magnitude = std::max(std::fabs(minimum[j]), std::fabs(maximum[j]));
+    error[j] = (maximum[j] - minimum[j]) / (2.0f * 65535.0f) + magnitude * 2.0f * 1.1920929e-7f;
+  }
+
+  return error;
+}
+
+inline void aabb_encode_batch(const glm::vec3 *source, size_t count, const glm::vec3 &minimum, const glm::vec3 &maximum, uint16_t *target)
+{
+  float offset[3];
+  float scale[3];
+
+  for(int j = 0; j < 3; j++)
+  {
+    float extent = maximum[j] - minimum[j];
+
+    offset[j] = minimum[j];
+    scale[j] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+  }
+
+  for(size_t i = 0; i < count; i++)
+  {
+    for(int j = 0; j < 3; j++)
+    {
+      float value = (source[i][j] - offset[j]) * scale[j];
+      value = std::min(std::max(value, 0.0f), 65535.0f);
+
+      target[i * 3 + j] = uint16_t(value + 0.5f);
+    }
+  }
+}
+
+inline void aabb_decode_batch(const uint16_t *source, size_t count, const glm::vec3 &minimum, const glm::vec3 &maximum, glm::vec3 *target)
+{
+  float offset[3];
+  float scale[3];
+
+  for(int j = 0; j < 3; j++)
+  {
+    offset[j] = minimum[j];
+    scale[j] = (maximum[j] - minimum[j]) / 65535.0f;
+  }
+
+  for(size_t i = 0; i < count; i++)
+  {
+    for(int j = 0; j < 3; j++)
+    {
+      target[i][j] = offset[j] + float(source[i * 3 + j]) * scale[j];
+    }
+  }
+}
@@ -13,7 +13,7 @@ GLM_Type glm_vec_read(tinyxml2::XMLElement *element)
   std::vector<unsigned char> buffer;
   buffer = base64Decode(get_std_string(element));
 
-  if(buffer.size() < 8 || buffer.size() > 8)
+  if(buffer.size() != GLM_Type::length() * sizeof(Type))
   {
     return GLM_Type();
   }
@@ -40,6 +40,25 @@ void glm_vec_write(GLM_Type vector, tinyxml2::XMLPrinter *printer)
   }
 }
 
+// Whole array of glm values in one element, see array_write()
+template <class GLM_Type>
+void glm_array_write(const GLM_Type *source, size_t count, tinyxml2::XMLPrinter *printer)
+{
+  array_write<GLM_Type>(source, count, printer);
+}
+
+template <class GLM_Type>
+void glm_array_write(const std::vector<GLM_Type> &source, tinyxml2::XMLPrinter *printer)
+{
+  array_write<GLM_Type>(source.data(), source.size(), printer);
+}
+
+template <class GLM_Type>
+int glm_array_read(tinyxml2::XMLElement *element, std::vector<GLM_Type> &table)
+{
+  return array_read<GLM_Type>(element, table);
+}
+
 #ifdef _FLOVER_
 void dimensions_write(glm::vec3 *dimensions_min, glm::vec3 *dimensions_max, tinyxml2::XMLPrinter *printer);
 void dimensions_read(tinyxml2::XMLElement *element, glm::vec3 *dimensions_min, glm::vec3 *dimensions_max);
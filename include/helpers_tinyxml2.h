@@ -4,23 +4,235 @@
 #include <type_convert.h>
 #include <tinyxml2.h>
 #include <Base64.h>
+#include <string_view>
+#include <cstring>
+#include <algorithm>
 
 bool get_bool(tinyxml2::XMLElement *element);
 void print_bool(bool value, tinyxml2::XMLPrinter *printer);
 bool string_to_bool(std::string value);
 std::string get_std_string(tinyxml2::XMLElement *element);
+// Text of the element without a copy, valid as long as the document
+std::string_view get_string_view(tinyxml2::XMLElement *element);
+
+// Pushes the data as Base64 text to the open element, in chunks without encoding the whole data at once
+void base64_print(std::string_view data, tinyxml2::XMLPrinter *printer);
+// Decodes the Base64 text of the element in chunks to the sink, returns EXIT_FAILURE on invalid text
+int base64_read(tinyxml2::XMLElement *element, Base64_Decoder::Sink sink);
+
+#ifdef _ZLIB
+#ifndef XML_ZLIB_DECOMPRESS_MAX_SIZE
+// Bigger output is refused, as a small element can inflate to much more
+#define XML_ZLIB_DECOMPRESS_MAX_SIZE (size_t(64) * 1024 * 1024)
+#endif
+
+struct XML_Options_Table;
+
+/*
+ * Streaming versions of the node compression, data flows through
+ * zlib and Base64 in chunks, so only constant extra memory is needed.
+ * Text, which is no zlib stream, is read with std_string_decompress()
+ * as the files written before.
+ */
+void xml_zlib_compress_print(std::string_view xml, tinyxml2::XMLPrinter *printer, XML_Options_Table &options);
+std::string xml_zlib_read_decompress(tinyxml2::XMLElement *element);
+#endif
+
+#ifdef _ZSTD
+#ifndef XML_STRING_COMPRESSED_ZSTD
+#define XML_STRING_COMPRESSED_ZSTD "Compressed_zstd"
+#endif
+
+struct XML_Options_Table;
+class Zstd_Dictionary;
+
+// Node compression with zstd, with the dictionary when it is loaded. Nothing is printed on failure.
+int xml_zstd_compress_print(std::string_view xml, tinyxml2::XMLPrinter *printer, XML_Options_Table &options, Zstd_Dictionary *dictionary);
+std::string xml_zstd_read_decompress(tinyxml2::XMLElement *element, Zstd_Dictionary *dictionary);
+#endif
 
 template <typename Type>
 Type variable_read(tinyxml2::XMLElement *element)
 {
-  return uchar_to_variable<Type>(base64Decode(get_std_string(element)));
+  std::string_view text = get_string_view(element);
+  unsigned char buffer[((sizeof(Type) + 2) / 3) * 3];
+  size_t size = 0;
+
+  if(text.size() > (sizeof(buffer) / 3) * 4 ||
+     base64Decode(text, buffer, &size) == EXIT_FAILURE ||
+     size != sizeof(Type))
+  {
+    Type type = 0;
+
+    return type;
+  }
+
+  Type type;
+  std::memcpy(&type, buffer, sizeof(Type));
+
+  return type;
 }
 
 template <typename Type>
 void variable_write(Type variable, tinyxml2::XMLPrinter *printer)
 {
-  printer->PushText(base64Encode(variable_to_uchar<Type>(variable)).c_str());
+  char buffer[((sizeof(Type) + 2) / 3) * 4 + 1];
+
+  buffer[base64Encode((const unsigned char*)&variable, sizeof(Type), buffer)] = '\0';
+  printer->PushText(buffer);
+}
+
+#ifndef XML_STRING_VARINT
+#define XML_STRING_VARINT "Varint"
+#endif
+
+// Integer as Base64 of its varint, see varint_push_back()
+template <typename Type>
+Type varint_read(tinyxml2::XMLElement *element)
+{
+  std::string_view text = get_string_view(element);
+  unsigned char buffer[((VARINT_MAX_SIZE + 2) / 3) * 3];
+  size_t size = 0;
+  Type type = 0;
+
+  if(text.size() > (sizeof(buffer) / 3) * 4 ||
+     base64Decode(text, buffer, &size) == EXIT_FAILURE)
+  {
+    return type;
+  }
+
+  uint64_t value = 0;
+  size_t used = 0;
+
+  if(varint_decode(buffer, size, &value, &used) == EXIT_FAILURE)
+  {
+    return type;
+  }
+
+  if(std::is_signed<Type>::value)
+  {
+    type = Type(zigzag_decode<int64_t>(value));
+  }
+
+  else
+  {
+    type = Type(value);
+  }
+
+  return type;
 }
 
+template <typename Type>
+void varint_write(Type variable, tinyxml2::XMLPrinter *printer)
+{
+  unsigned char buffer[VARINT_MAX_SIZE];
+  char text[((VARINT_MAX_SIZE + 2) / 3) * 4 + 1];
+  uint64_t value;
+
+  if(std::is_signed<Type>::value)
+  {
+    value = uint64_t(zigzag_encode<int64_t>(int64_t(variable)));
+  }
+
+  else
+  {
+    value = uint64_t(variable);
+  }
+
+  text[base64Encode(buffer, varint_encode(value, buffer), text)] = '\0';
+  printer->PushText(text);
+}
+
+
+/*
+ * Whole array of trivially copyable values in one element. The decoded
+ * data is the count as uint64_t followed by the values, in the layout of
+ * vectorType_to_vectorUChar(). It is streamed through Base64_Encoder.
+ */
+template <typename Type>
+void array_write(const Type *source, size_t count, tinyxml2::XMLPrinter *printer)
+{
+  Base64_Encoder encoder([printer](const char *text, size_t size)
+  {
+    if(size > 0)
+    {
+      printer->PushText(text);
+    }
+  });
+
+  uint64_t size = count;
+  unsigned char prefix[sizeof(uint64_t)];
+  array_to_uchar<uint64_t>(&size, 1, prefix);
+
+  encoder.update(prefix, sizeof(prefix));
+
+  if(count > 0)
+  {
+    encoder.update((const unsigned char*)source, count * sizeof(Type));
+  }
+
+  encoder.finish();
+}
+
+template <typename Type>
+void array_write(const std::vector<Type> &source, tinyxml2::XMLPrinter *printer)
+{
+  array_write<Type>(source.data(), source.size(), printer);
+}
+
+// Decodes straight into table, whose capacity is reused. On failure table is left empty.
+template <typename Type>
+int array_read(tinyxml2::XMLElement *element, std::vector<Type> &table)
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "Type has to be trivially copyable");
+
+  size_t size = base64DecodedLength(get_string_view(element));
+
+  if(size < sizeof(uint64_t) || (size - sizeof(uint64_t)) % sizeof(Type) != 0)
+  {
+    table.clear();
+    return EXIT_FAILURE;
+  }
+
+  table.resize((size - sizeof(uint64_t)) / sizeof(Type));
+
+  unsigned char prefix[sizeof(uint64_t)];
+  unsigned char *target = (unsigned char*)table.data();
+  size_t position = 0;
+
+  int status = base64_read(element, [&](const unsigned char *data, size_t data_size)
+  {
+    if(position + data_size > size)
+    {
+      data_size = size - position;
+    }
+
+    size_t prefix_size = 0;
+
+    if(position < sizeof(prefix))
+    {
+      prefix_size = std::min(data_size, sizeof(prefix) - position);
+      std::memcpy(prefix + position, data, prefix_size);
+    }
+
+    if(data_size > prefix_size)
+    {
+      std::memcpy(target + (position + prefix_size - sizeof(prefix)), data + prefix_size, data_size - prefix_size);
+    }
+
+    position += data_size;
+  });
+
+  uint64_t count = 0;
+  uchar_to_array<uint64_t>(prefix, sizeof(prefix), &count);
+
+  if(status == EXIT_FAILURE || position != size || count != table.size())
+  {
+    table.clear();
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
 
 #endif
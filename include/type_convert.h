@@ -5,6 +5,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <stdexcept>
 
 // Union type whitch is used to convert wanted type to unsigned char and back.
 template <typename Type>
@@ -19,11 +22,112 @@ union type_char_convert
   }
 };
 
-std::vector<float> vectorUChar_to_vectorFloat(std::vector<unsigned char> source);
-std::vector<unsigned char> vectorFloat_to_vectorUChar(std::vector<float> &source);
+std::vector<float> vectorUChar_to_vectorFloat(const std::vector<unsigned char> &source);
+std::vector<unsigned char> vectorFloat_to_vectorUChar(const std::vector<float> &source);
 
-std::vector<unsigned int> vectorUChar_to_vectorUINT(std::vector<unsigned char> source);
-std::vector<unsigned char> vectorUINT_to_vectorUChar(std::vector<unsigned int> &source);
+std::vector<unsigned int> vectorUChar_to_vectorUINT(const std::vector<unsigned char> &source);
+std::vector<unsigned char> vectorUINT_to_vectorUChar(const std::vector<unsigned int> &source);
+
+constexpr bool host_is_little_endian()
+{
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+  return __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__;
+#else
+  return true;
+#endif
+}
+
+// Reverses the bytes of each of the count elements, written so that compilers vectorize it
+template <typename Type>
+void byte_swap_array(unsigned char *data, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    unsigned char *element = data + i * sizeof(Type);
+
+    for(size_t j = 0; j < sizeof(Type) / 2; j++)
+    {
+      unsigned char temp = element[j];
+      element[j] = element[sizeof(Type) - 1 - j];
+      element[sizeof(Type) - 1 - j] = temp;
+    }
+  }
+}
+
+/*
+ * Bulk conversions between arrays of trivially copyable types and bytes,
+ * done with one memcpy. With little_endian the bytes are stored in
+ * little-endian order, on big-endian hosts every element is then swapped.
+ */
+template <typename Type>
+void array_to_uchar(const Type *source, size_t count, unsigned char *target, bool little_endian = false)
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "Type has to be trivially copyable");
+
+  if(count == 0)
+  {
+    return void();
+  }
+
+  std::memcpy(target, source, count * sizeof(Type));
+
+  if(little_endian && host_is_little_endian() == false)
+  {
+    byte_swap_array<Type>(target, count);
+  }
+}
+
+// size is in bytes, count of elements is size / sizeof(Type)
+template <typename Type>
+void uchar_to_array(const unsigned char *source, size_t size, Type *target, bool little_endian = false)
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "Type has to be trivially copyable");
+
+  size_t count = size / sizeof(Type);
+
+  if(count == 0)
+  {
+    return void();
+  }
+
+  std::memcpy(target, source, count * sizeof(Type));
+
+  if(little_endian && host_is_little_endian() == false)
+  {
+    byte_swap_array<Type>((unsigned char*)target, count);
+  }
+}
+
+template <typename Type>
+std::vector<unsigned char> vectorType_to_vectorUChar(const Type *source, size_t count, bool little_endian = false)
+{
+  std::vector<unsigned char> buffer(count * sizeof(Type));
+  array_to_uchar<Type>(source, count, buffer.data(), little_endian);
+
+  return buffer;
+}
+
+template <typename Type>
+std::vector<unsigned char> vectorType_to_vectorUChar(const std::vector<Type> &source, bool little_endian = false)
+{
+  return vectorType_to_vectorUChar<Type>(source.data(), source.size(), little_endian);
+}
+
+// Trailing bytes, which do not fill a whole element, are left out
+template <typename Type>
+std::vector<Type> vectorUChar_to_vectorType(const unsigned char *source, size_t size, bool little_endian = false)
+{
+  std::vector<Type> buffer(size / sizeof(Type));
+  uchar_to_array<Type>(source, size, buffer.data(), little_endian);
+
+  return buffer;
+}
+
+template <typename Type>
+std::vector<Type> vectorUChar_to_vectorType(const std::vector<unsigned char> &source, bool little_endian = false)
+{
+  return vectorUChar_to_vectorType<Type>(source.data(), source.size(), little_endian);
+}
 
 
 // Convertin given variable to the std::vector<unsigned char>
@@ -109,4 +213,309 @@ void variable_push_back(std::vector<unsigned char> &table, Variable_T variable)
   }
 }
 
+/*
+ * Read-only view of bytes as an array of Type, for example of a
+ * std::vector<unsigned char> or a mmap region. The bytes are used in place
+ * when they are aligned for Type, only misaligned bytes are copied once
+ * to a buffer owned by the view. The bytes have to stay alive as long as
+ * the view, and their size has to be a multiple of sizeof(Type), else
+ * the view is empty and is_valid() returns false.
+ */
+template <typename Type>
+class Type_View
+{
+public:
+  static_assert(std::is_trivially_copyable<Type>::value, "Type has to be trivially copyable");
+
+  Type_View()
+  {
+    this->clear();
+  }
+
+  Type_View(const unsigned char *source, size_t size)
+  {
+    this->set(source, size);
+  }
+
+  Type_View(const std::vector<unsigned char> &source)
+  {
+    this->set(source.data(), source.size());
+  }
+
+  Type_View(const Type_View &other)
+  {
+    *this = other;
+  }
+
+  Type_View(Type_View &&other) = default;
+  Type_View &operator=(Type_View &&other) = default;
+
+  Type_View &operator=(const Type_View &other)
+  {
+    this->copy = other.copy;
+    this->pointer = other.is_copy() ? this->copy.data() : other.pointer;
+    this->count = other.count;
+    this->valid = other.valid;
+
+    return *this;
+  }
+
+  void set(const unsigned char *source, size_t size)
+  {
+    this->clear();
+
+    if(size % sizeof(Type) != 0 || (source == nullptr && size != 0))
+    {
+      this->valid = false;
+      return void();
+    }
+
+    this->count = size / sizeof(Type);
+
+    if(reinterpret_cast<uintptr_t>(source) % alignof(Type) == 0)
+    {
+      this->pointer = reinterpret_cast<const Type*>(source);
+    }
+
+    else
+    {
+      this->copy.resize(this->count);
+      std::memcpy(this->copy.data(), source, size);
+      this->pointer = this->copy.data();
+    }
+  }
+
+  void clear()
+  {
+    this->pointer = nullptr;
+    this->count = 0;
+    this->copy.clear();
+    this->valid = true;
+  }
+
+  const Type *data() const
+  {
+    return this->pointer;
+  }
+
+  size_t size() const
+  {
+    return this->count;
+  }
+
+  bool empty() const
+  {
+    return this->count == 0;
+  }
+
+  bool is_valid() const
+  {
+    return this->valid;
+  }
+
+  // true if the bytes were misaligned and the view holds a copy
+  bool is_copy() const
+  {
+    return this->copy.empty() == false;
+  }
+
+  const Type &operator[](size_t index) const
+  {
+    return this->pointer[index];
+  }
+
+  const Type &at(size_t index) const
+  {
+    if(index >= this->count)
+    {
+      throw std::out_of_range("Type_View::at()");
+    }
+
+    return this->pointer[index];
+  }
+
+  const Type *begin() const
+  {
+    return this->pointer;
+  }
+
+  const Type *end() const
+  {
+    return this->pointer + this->count;
+  }
+
+private:
+  const Type *pointer;
+  size_t count;
+  std::vector<Type> copy;
+  bool valid;
+};
+
+// Same as variable_pop_back(), but for count of variables, which are viewed in place
+template <typename Variable_T>
+bool view_pop_back(std::vector<unsigned char> &table, Type_View<Variable_T> &view, uint64_t count, uint64_t &offset)
+{
+  uint64_t size = count * sizeof(Variable_T);
+
+  if(offset > table.size() || size > table.size() - offset)
+  {
+    return EXIT_FAILURE;
+  }
+
+  view.set(table.data() + offset, size);
+  offset = offset + size;
+
+  return EXIT_SUCCESS;
+}
+
+/*
+ * ZigZag maps signed integers to unsigned ones so that small negative
+ * values stay small: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...
+ */
+template <typename Type>
+typename std::make_unsigned<Type>::type zigzag_encode(Type value)
+{
+  typedef typename std::make_unsigned<Type>::type Unsigned_T;
+
+  return (Unsigned_T(value) << 1) ^ Unsigned_T(value >> (sizeof(Type) * 8 - 1));
+}
+
+template <typename Type>
+Type zigzag_decode(typename std::make_unsigned<Type>::type value)
+{
+  return Type((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Longest LEB128 varint, of 64-bit value
+#define VARINT_MAX_SIZE 10
+
+/*
+ * LEB128 varint, 7 bits on each byte, lowest first. The high bit of the byte
+ * is set when more bytes follow. Returns the count of written bytes.
+ */
+inline size_t varint_encode(uint64_t value, unsigned char *output)
+{
+  size_t size = 0;
+
+  while(value >= 0x80)
+  {
+    output[size++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+
+  output[size++] = (unsigned char)value;
+
+  return size;
+}
+
+/*
+ * Decodes one varint of the input, used is set to the count of read bytes.
+ * When 8 bytes are readable the terminating byte is searched from all of them
+ * at once and the 7-bit groups are packed with masks, without a loop.
+ */
+inline int varint_decode(const unsigned char *input, size_t size, uint64_t *value, size_t *used)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  if(size >= 8 && host_is_little_endian())
+  {
+    uint64_t word;
+    std::memcpy(&word, input, 8);
+
+    uint64_t stop = ~word & 0x8080808080808080ULL;
+
+    if(stop != 0)
+    {
+      size_t bytes = __builtin_ctzll(stop) / 8 + 1;
+
+      if(bytes < 8)
+      {
+        word &= (1ULL << (bytes * 8)) - 1;
+      }
+
+      word &= 0x7F7F7F7F7F7F7F7FULL;
+      word = ((word & 0x7F007F007F007F00ULL) >> 1) | (word & 0x007F007F007F007FULL);
+      word = ((word & 0x3FFF00003FFF0000ULL) >> 2) | (word & 0x00003FFF00003FFFULL);
+      word = ((word & 0x0FFFFFFF00000000ULL) >> 4) | (word & 0x000000000FFFFFFFULL);
+
+      *value = word;
+      *used = bytes;
+
+      return EXIT_SUCCESS;
+    }
+  }
+#endif
+
+  uint64_t result = 0;
+
+  for(size_t i = 0; i < size && i < VARINT_MAX_SIZE; i++)
+  {
+    result |= uint64_t(input[i] & 0x7F) << (7 * i);
+
+    if((input[i] & 0x80) == 0)
+    {
+      *value = result;
+      *used = i + 1;
+
+      return EXIT_SUCCESS;
+    }
+  }
+
+  return EXIT_FAILURE;
+}
+
+// Same as variable_push_back(), but as a varint. Signed types are ZigZag encoded.
+template <typename Variable_T>
+void varint_push_back(std::vector<unsigned char> &table, Variable_T variable)
+{
+  static_assert(std::is_integral<Variable_T>::value, "varint needs an integer type");
+
+  unsigned char buffer[VARINT_MAX_SIZE];
+  uint64_t value;
+
+  if(std::is_signed<Variable_T>::value)
+  {
+    value = uint64_t(zigzag_encode<int64_t>(int64_t(variable)));
+  }
+
+  else
+  {
+    value = uint64_t(variable);
+  }
+
+  table.insert(table.end(), buffer, buffer + varint_encode(value, buffer));
+}
+
+template <typename Variable_T>
+bool varint_pop_back(std::vector<unsigned char> &table, Variable_T &variable, uint64_t &offset)
+{
+  static_assert(std::is_integral<Variable_T>::value, "varint needs an integer type");
+
+  if(offset >= table.size())
+  {
+    return EXIT_FAILURE;
+  }
+
+  uint64_t value = 0;
+  size_t used = 0;
+
+  if(varint_decode(table.data() + offset, table.size() - offset, &value, &used) == EXIT_FAILURE)
+  {
+    return EXIT_FAILURE;
+  }
+
+  if(std::is_signed<Variable_T>::value)
+  {
+    variable = Variable_T(zigzag_decode<int64_t>(value));
+  }
+
+  else
+  {
+    variable = Variable_T(value);
+  }
+
+  offset = offset + used;
+
+  return EXIT_SUCCESS;
+}
+
 #endif
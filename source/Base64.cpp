@@ -1,139 +1,773 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
 #include <Base64.h>
 
-std::basic_string<char> base64Encode(std::vector<unsigned char> inputBuffer)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define _BASE64_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/*
+ * The encoders and decoders work in two steps, a vectorized kernel handles
+ * as much of the input as it can and the scalar code finishes the tail.
+ * Kernels are selected once at runtime by the features of the CPU.
+ *
+ * Encode kernel returns the count of consumed input bytes (multiple of 3),
+ * decode kernel the count of consumed chars (multiple of 4). Decode kernel
+ * stops on the first block with invalid chars, the scalar decoder will
+ * then find and report the error.
+ */
+typedef size_t (*Base64_Encode_Kernel)(const unsigned char *input, size_t input_size, char *output);
+typedef size_t (*Base64_Decode_Kernel)(const char *input, size_t input_size, unsigned char *output, size_t output_size);
+
+struct Base64_Kernels
+{
+  Base64_Encode_Kernel encode;
+  Base64_Decode_Kernel decode;
+};
+
+// 6-bit value of the char, 0x80 when the char is not in the alphabet
+struct Base64_Decode_Table
 {
-  if(inputBuffer.size() == 0)
+  unsigned char value[256];
+
+  constexpr Base64_Decode_Table() : value()
   {
-    return std::basic_string<char>();
+    const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    for(int i = 0; i < 256; i++)
+    {
+      value[i] = 0x80;
+    }
+
+    for(int i = 0; i < 64; i++)
+    {
+      value[(unsigned char)alphabet[i]] = (unsigned char)i;
+    }
   }
+};
 
-  std::basic_string<char> encodedString;
-  encodedString.reserve(((inputBuffer.size()/3) + (inputBuffer.size() % 3 > 0)) * 4);
-  long temp;
-  std::vector<unsigned char>::iterator cursor = inputBuffer.begin();
+static constexpr Base64_Decode_Table decodeLookup;
+
+static size_t base64_encode_scalar(const unsigned char *input, size_t input_size, char *output)
+{
+  uint32_t temp;
+  const unsigned char *cursor = input;
+  char *out = output;
 
-  for(size_t idx = 0; idx < inputBuffer.size()/3; idx++)
+  for(size_t idx = 0; idx < input_size/3; idx++)
   {
-    temp  = (*cursor++) << 16; //Convert to big endian
-    temp += (*cursor++) << 8;
-    temp += (*cursor++);
-    encodedString.append(1,encodeLookup[(temp & 0x00FC0000) >> 18]);
-    encodedString.append(1,encodeLookup[(temp & 0x0003F000) >> 12]);
-    encodedString.append(1,encodeLookup[(temp & 0x00000FC0) >> 6 ]);
-    encodedString.append(1,encodeLookup[(temp & 0x0000003F)      ]);
+    temp = (uint32_t(cursor[0]) << 16) | (uint32_t(cursor[1]) << 8) | cursor[2]; //Convert to big endian
+    cursor += 3;
+
+    out[0] = encodeLookup[(temp >> 18) & 0x3F];
+    out[1] = encodeLookup[(temp >> 12) & 0x3F];
+    out[2] = encodeLookup[(temp >> 6 ) & 0x3F];
+    out[3] = encodeLookup[(temp      ) & 0x3F];
+    out += 4;
   }
 
-  switch(inputBuffer.size() % 3)
+  switch(input_size % 3)
   {
   case 1:
-    temp  = (*cursor++) << 16; //Convert to big endian
-    encodedString.append(1,encodeLookup[(temp & 0x00FC0000) >> 18]);
-    encodedString.append(1,encodeLookup[(temp & 0x0003F000) >> 12]);
-    encodedString.append(2,padCharacter);
+    temp = uint32_t(cursor[0]) << 16;
+    out[0] = encodeLookup[(temp >> 18) & 0x3F];
+    out[1] = encodeLookup[(temp >> 12) & 0x3F];
+    out[2] = padCharacter;
+    out[3] = padCharacter;
+    out += 4;
     break;
 
   case 2:
-    temp  = (*cursor++) << 16; //Convert to big endian
-    temp += (*cursor++) << 8;
-    encodedString.append(1,encodeLookup[(temp & 0x00FC0000) >> 18]);
-    encodedString.append(1,encodeLookup[(temp & 0x0003F000) >> 12]);
-    encodedString.append(1,encodeLookup[(temp & 0x00000FC0) >> 6 ]);
-    encodedString.append(1,padCharacter);
+    temp = (uint32_t(cursor[0]) << 16) | (uint32_t(cursor[1]) << 8);
+    out[0] = encodeLookup[(temp >> 18) & 0x3F];
+    out[1] = encodeLookup[(temp >> 12) & 0x3F];
+    out[2] = encodeLookup[(temp >> 6 ) & 0x3F];
+    out[3] = padCharacter;
+    out += 4;
     break;
   }
 
-  return encodedString;
+  return out - output;
 }
 
-std::vector<unsigned char> base64Decode(const std::basic_string<char> input)
+/*
+ * Decodes the quanta without padding, returns false on invalid chars.
+ */
+static bool base64_decode_scalar(const char *input, size_t input_size, unsigned char *output)
 {
-  if(input.length() % 4)  //Sanity check
-    return std::vector<unsigned char>(0);
+  const unsigned char *cursor = (const unsigned char*)input;
+
+  for(size_t idx = 0; idx < input_size/4; idx++)
+  {
+    uint32_t a = decodeLookup.value[cursor[0]];
+    uint32_t b = decodeLookup.value[cursor[1]];
+    uint32_t c = decodeLookup.value[cursor[2]];
+    uint32_t d = decodeLookup.value[cursor[3]];
+
+    if((a | b | c | d) & 0x80)
+    {
+      return false;
+    }
+
+    uint32_t temp = (a << 18) | (b << 12) | (c << 6) | d;
+
+    output[0] = (temp >> 16) & 0xFF;
+    output[1] = (temp >> 8) & 0xFF;
+    output[2] = temp & 0xFF;
+
+    cursor += 4;
+    output += 3;
+  }
+
+  return true;
+}
+
+static size_t base64_encode_none(const unsigned char *, size_t, char *)
+{
+  return 0;
+}
+
+static size_t base64_decode_none(const char *, size_t, unsigned char *, size_t)
+{
+  return 0;
+}
+
+#ifdef _BASE64_X86_SIMD
+
+/*
+ * SSSE3 and AVX2 kernels follow the algorithms of Wojciech Muła and
+ * Daniel Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions".
+ */
+__attribute__((target("ssse3")))
+static size_t base64_encode_ssse3(const unsigned char *input, size_t input_size, char *output)
+{
+  const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+  size_t consumed = 0;
+
+  // 12 bytes are used on each round, but 16 are loaded
+  while(consumed + 16 <= input_size)
+  {
+    __m128i in = _mm_loadu_si128((const __m128i*)(input + consumed));
+    in = _mm_shuffle_epi8(in, shuffle);
+
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    __m128i offset = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    offset = _mm_sub_epi8(offset, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+
+    _mm_storeu_si128((__m128i*)(output + (consumed / 3) * 4), _mm_add_epi8(indices, _mm_shuffle_epi8(lut, offset)));
+
+    consumed += 12;
+  }
+
+  return consumed;
+}
+
+__attribute__((target("ssse3")))
+static size_t base64_decode_ssse3(const char *input, size_t input_size, unsigned char *output, size_t output_size)
+{
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m128i mask_2F = _mm_set1_epi8(0x2F);
+  size_t consumed = 0;
+
+  // 12 bytes are produced on each round, but 16 are stored
+  while(consumed + 16 <= input_size && (consumed / 4) * 3 + 16 <= output_size)
+  {
+    __m128i in = _mm_loadu_si128((const __m128i*)(input + consumed));
+
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2F);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2F));
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF)
+    {
+      break;
+    }
+
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2F), hi_nibbles));
+    in = _mm_add_epi8(in, roll);
+
+    const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+
+    _mm_storeu_si128((__m128i*)(output + (consumed / 4) * 3), _mm_shuffle_epi8(merged, pack));
+
+    consumed += 16;
+  }
+
+  return consumed;
+}
+
+__attribute__((target("avx2")))
+static size_t base64_encode_avx2(const unsigned char *input, size_t input_size, char *output)
+{
+  const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                           1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i lut = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                                       65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+  size_t consumed = 0;
+
+  // 24 bytes are used on each round, the second lane loads 16 bytes from +12
+  while(consumed + 28 <= input_size)
+  {
+    const unsigned char *cursor = input + consumed;
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)cursor)),
+                                         _mm_loadu_si128((const __m128i*)(cursor + 12)), 1);
+    in = _mm256_shuffle_epi8(in, shuffle);
+
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i offset = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    offset = _mm256_sub_epi8(offset, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+
+    _mm256_storeu_si256((__m256i*)(output + (consumed / 3) * 4), _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, offset)));
+
+    consumed += 24;
+  }
+
+  return consumed;
+}
+
+__attribute__((target("avx2")))
+static size_t base64_decode_avx2(const char *input, size_t input_size, unsigned char *output, size_t output_size)
+{
+  const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                          0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                          0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i mask_2F = _mm256_set1_epi8(0x2F);
+  size_t consumed = 0;
+
+  // 24 bytes are produced on each round, but 32 are stored
+  while(consumed + 32 <= input_size && (consumed / 4) * 3 + 32 <= output_size)
+  {
+    __m256i in = _mm256_loadu_si256((const __m256i*)(input + consumed));
+
+    const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2F);
+    const __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, mask_2F));
+    const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+
+    if(_mm256_testz_si256(lo, hi) == 0)
+    {
+      break;
+    }
+
+    const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2F), hi_nibbles));
+    in = _mm256_add_epi8(in, roll);
+
+    __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+    merged = _mm256_shuffle_epi8(merged, pack);
+    merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+    _mm256_storeu_si256((__m256i*)(output + (consumed / 4) * 3), merged);
+
+    consumed += 32;
+  }
+
+  return consumed;
+}
+
+// _mm512_permutexvar_epi8() gives a false warning on GCC
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/*
+ * AVX-512 VBMI kernels, Wojciech Muła and Daniel Lemire,
+ * "Base64 encoding and decoding at almost the speed of a memory copy".
+ */
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static size_t base64_encode_avx512(const unsigned char *input, size_t input_size, char *output)
+{
+  const __m512i shuffle = _mm512_setr_epi32(0x01020001, 0x04050304, 0x07080607, 0x0A0B090A,
+                                            0x0D0E0C0D, 0x10110F10, 0x13141213, 0x16171516,
+                                            0x191A1819, 0x1C1D1B1C, 0x1F201E1F, 0x22232122,
+                                            0x25262425, 0x28292728, 0x2B2C2A2B, 0x2E2F2D2E);
+  const __m512i shifts = _mm512_set1_epi64(0x3036242A1016040A);
+  const __m512i lookup = _mm512_loadu_si512((const void*)encodeLookup);
+  size_t consumed = 0;
+
+  // 48 bytes are used on each round, but 64 are loaded
+  while(consumed + 64 <= input_size)
+  {
+    __m512i in = _mm512_loadu_si512((const void*)(input + consumed));
+    in = _mm512_permutexvar_epi8(shuffle, in);
+
+    const __m512i indices = _mm512_multishift_epi64_epi8(shifts, in);
+
+    _mm512_storeu_si512((void*)(output + (consumed / 3) * 4), _mm512_permutexvar_epi8(indices, lookup));
+
+    consumed += 48;
+  }
+
+  return consumed;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static size_t base64_decode_avx512(const char *input, size_t input_size, unsigned char *output, size_t output_size)
+{
+  // decodeLookup.value for chars 0 - 127, 0x80 on invalid chars
+  const __m512i lookup_0 = _mm512_loadu_si512((const void*)decodeLookup.value);
+  const __m512i lookup_1 = _mm512_loadu_si512((const void*)(decodeLookup.value + 64));
+  const __m512i pack = _mm512_setr_epi32(0x06000102, 0x090A0405, 0x0C0D0E08, 0x16101112,
+                                         0x191A1415, 0x1C1D1E18, 0x26202122, 0x292A2425,
+                                         0x2C2D2E28, 0x36303132, 0x393A3435, 0x3C3D3E38,
+                                         0x00000000, 0x00000000, 0x00000000, 0x00000000);
+  size_t consumed = 0;
+
+  // 48 bytes are produced on each round, but 64 are stored
+  while(consumed + 64 <= input_size && (consumed / 4) * 3 + 64 <= output_size)
+  {
+    const __m512i in = _mm512_loadu_si512((const void*)(input + consumed));
+    const __m512i translated = _mm512_permutex2var_epi8(lookup_0, in, lookup_1);
+
+    if(_mm512_movepi8_mask(_mm512_or_si512(translated, in)) != 0)
+    {
+      break;
+    }
+
+    const __m512i merged = _mm512_madd_epi16(_mm512_maddubs_epi16(translated, _mm512_set1_epi32(0x01400140)), _mm512_set1_epi32(0x00011000));
+
+    _mm512_storeu_si512((void*)(output + (consumed / 4) * 3), _mm512_permutexvar_epi8(pack, merged));
+
+    consumed += 64;
+  }
+
+  return consumed;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+static Base64_Kernels base64_kernels_select()
+{
+  Base64_Kernels kernels;
+  kernels.encode = base64_encode_none;
+  kernels.decode = base64_decode_none;
+
+#ifdef _BASE64_X86_SIMD
+  __builtin_cpu_init();
+
+  if(__builtin_cpu_supports("avx512vbmi") && __builtin_cpu_supports("avx512bw"))
+  {
+    kernels.encode = base64_encode_avx512;
+    kernels.decode = base64_decode_avx512;
+  }
+
+  else if(__builtin_cpu_supports("avx2"))
+  {
+    kernels.encode = base64_encode_avx2;
+    kernels.decode = base64_decode_avx2;
+  }
+
+  else if(__builtin_cpu_supports("ssse3"))
+  {
+    kernels.encode = base64_encode_ssse3;
+    kernels.decode = base64_decode_ssse3;
+  }
+#endif
+
+  return kernels;
+}
+
+static const Base64_Kernels &base64_kernels()
+{
+  static const Base64_Kernels kernels = base64_kernels_select();
+  return kernels;
+}
+
+size_t base64EncodedLength(size_t input_size)
+{
+  return ((input_size + 2) / 3) * 4;
+}
+
+size_t base64DecodedLength(std::string_view input)
+{
+  if(input.empty() || input.size() % 4)
+  {
+    return 0;
+  }
 
   size_t padding = 0;
 
-  if(input.length())
+  if(input[input.size() - 1] == padCharacter)
   {
-    if(input[input.length()-1] == padCharacter)
+    padding++;
+
+    if(input[input.size() - 2] == padCharacter)
+    {
       padding++;
+    }
+  }
+
+  return (input.size() / 4) * 3 - padding;
+}
+
+std::basic_string<char> base64Encode(std::vector<unsigned char> inputBuffer)
+{
+  std::basic_string<char> encodedString;
+  base64Encode(std::string_view((const char*)inputBuffer.data(), inputBuffer.size()), encodedString);
+
+  return encodedString;
+}
 
-    if(input[input.length()-2] == padCharacter)
+size_t base64Encode(const unsigned char *input, size_t input_size, char *output)
+{
+  size_t consumed = 0;
+
+  // Short inputs, like the privateIDs, are not worth of the kernel call
+  if(input_size >= 64)
+  {
+    consumed = base64_kernels().encode(input, input_size, output);
+  }
+
+  return (consumed / 3) * 4 + base64_encode_scalar(input + consumed, input_size - consumed, output + (consumed / 3) * 4);
+}
+
+void base64Encode(std::string_view input, std::string &output)
+{
+  output.resize(base64EncodedLength(input.size()));
+
+  if(output.empty() == false)
+  {
+    base64Encode((const unsigned char*)input.data(), input.size(), &output[0]);
+  }
+}
+
+int base64Decode(std::string_view input, unsigned char *output, size_t *output_size)
+{
+  *output_size = 0;
+
+  if(input.size() % 4)  //Sanity check
+  {
+    return EXIT_FAILURE;
+  }
+
+  if(input.empty())
+  {
+    return EXIT_SUCCESS;
+  }
+
+  // Last quantum may have the padding, it is left for the scalar code
+  size_t body_size = input.size() - 4;
+  size_t consumed = 0;
+
+  if(body_size >= 64)
+  {
+    consumed = base64_kernels().decode(input.data(), body_size, output, (input.size() / 4) * 3);
+  }
+
+  if(base64_decode_scalar(input.data() + consumed, body_size - consumed, output + (consumed / 4) * 3) == false)
+  {
+    return EXIT_FAILURE;
+  }
+
+  const char *last = input.data() + body_size;
+  unsigned char *out = output + (body_size / 4) * 3;
+
+  size_t padding = 0;
+
+  if(last[3] == padCharacter)
+  {
+    padding++;
+
+    if(last[2] == padCharacter)
+    {
       padding++;
+    }
+  }
+
+  uint32_t a = decodeLookup.value[(unsigned char)last[0]];
+  uint32_t b = decodeLookup.value[(unsigned char)last[1]];
+  uint32_t c = padding < 2 ? decodeLookup.value[(unsigned char)last[2]] : 0;
+  uint32_t d = padding < 1 ? decodeLookup.value[(unsigned char)last[3]] : 0;
+
+  if((a | b | c | d) & 0x80)
+  {
+    return EXIT_FAILURE;
+  }
+
+  uint32_t temp = (a << 18) | (b << 12) | (c << 6) | d;
+
+  out[0] = (temp >> 16) & 0xFF;
+
+  if(padding < 2)
+  {
+    out[1] = (temp >> 8) & 0xFF;
   }
 
+  if(padding < 1)
+  {
+    out[2] = temp & 0xFF;
+  }
+
+  *output_size = (input.size() / 4) * 3 - padding;
+
+  return EXIT_SUCCESS;
+}
+
+int base64Decode(std::string_view input, std::string &output)
+{
+  size_t size = 0;
+  output.resize((input.size() / 4) * 3);
+
+  if(base64Decode(input, (unsigned char*)output.data(), &size) == EXIT_FAILURE)
+  {
+    output.clear();
+    return EXIT_FAILURE;
+  }
+
+  output.resize(size);
+
+  return EXIT_SUCCESS;
+}
+
+std::vector<unsigned char> base64Decode(const std::basic_string<char> input)
+{
   //Setup a vector to hold the result
-  std::vector<unsigned char> decodedBytes;
-  decodedBytes.reserve(((input.length()/4)*3) - padding);
-  long temp=0; //Holds decoded quanta
-  std::basic_string<char>::const_iterator cursor = input.begin();
+  std::vector<unsigned char> decodedBytes((input.length() / 4) * 3);
+  size_t size = 0;
 
-  while(cursor < input.end())
+  if(base64Decode(std::string_view(input), decodedBytes.data(), &size) == EXIT_FAILURE)
   {
-    for(size_t quantumPosition = 0; quantumPosition < 4; quantumPosition++)
+    return std::vector<unsigned char>(0);
+  }
+
+  decodedBytes.resize(size);
+
+  return decodedBytes;
+}
+
+std::string Base64_get_string(std::string_view input)
+{
+  std::string buffer;
+  base64Decode(input, buffer);
+  return buffer;
+}
+
+std::string Base64_encode_string(std::string_view input)
+{
+  std::string buffer;
+  base64Encode(input, buffer);
+  return buffer;
+}
+
+Base64_Encoder :: Base64_Encoder(Sink output_sink, size_t chunk_size)
+{
+  this->sink = output_sink;
+  this->buffer.resize(std::max<size_t>(chunk_size - chunk_size % 4, 4) + 1);
+  this->buffer_size = 0;
+  this->carry_size = 0;
+  this->written = 0;
+}
+
+void Base64_Encoder :: flush()
+{
+  if(this->buffer_size == 0)
+  {
+    return void();
+  }
+
+  this->buffer[this->buffer_size] = '\0';
+  this->sink(this->buffer.data(), this->buffer_size);
+  this->written += this->buffer_size;
+  this->buffer_size = 0;
+}
+
+void Base64_Encoder :: update(const unsigned char *input, size_t input_size)
+{
+  size_t capacity = this->buffer.size() - 1;
+
+  // Completes the quantum left from the last call
+  while(this->carry_size > 0 && this->carry_size < 3 && input_size > 0)
+  {
+    this->carry[this->carry_size++] = *input++;
+    input_size--;
+  }
+
+  if(this->carry_size == 3)
+  {
+    if(this->buffer_size + 4 > capacity)
     {
-      temp <<= 6;
+      this->flush();
+    }
+
+    this->buffer_size += base64Encode(this->carry, 3, this->buffer.data() + this->buffer_size);
+    this->carry_size = 0;
+  }
+
+  while(input_size >= 3)
+  {
+    if(this->buffer_size + 4 > capacity)
+    {
+      this->flush();
+    }
 
-      if(*cursor >= 0x41 && *cursor <= 0x5A)        // This area will need tweaking if
-        temp |= *cursor - 0x41;                 // you are using an alternate alphabet
+    size_t count = std::min(input_size / 3, (capacity - this->buffer_size) / 4) * 3;
 
-      else if(*cursor >= 0x61 && *cursor <= 0x7A)
-        temp |= *cursor - 0x47;
+    this->buffer_size += base64Encode(input, count, this->buffer.data() + this->buffer_size);
+    input += count;
+    input_size -= count;
+  }
 
-      else if(*cursor >= 0x30 && *cursor <= 0x39)
-        temp |= *cursor + 0x04;
+  while(input_size > 0)
+  {
+    this->carry[this->carry_size++] = *input++;
+    input_size--;
+  }
+}
 
-      else if(*cursor == 0x2B)
-        temp |= 0x3E; //change to 0x2D for URL alphabet
+void Base64_Encoder :: update(std::string_view input)
+{
+  this->update((const unsigned char*)input.data(), input.size());
+}
 
-      else if(*cursor == 0x2F)
-        temp |= 0x3F; //change to 0x5F for URL alphabet
+void Base64_Encoder :: finish()
+{
+  if(this->carry_size > 0)
+  {
+    if(this->buffer_size + 4 > this->buffer.size() - 1)
+    {
+      this->flush();
+    }
 
-      else if(*cursor == padCharacter)   //pad
-      {
-        switch(input.end() - cursor)
-        {
-        case 1: //One pad character
-          decodedBytes.push_back((temp >> 16) & 0x000000FF);
-          decodedBytes.push_back((temp >> 8) & 0x000000FF);
-          return decodedBytes;
+    this->buffer_size += base64Encode(this->carry, this->carry_size, this->buffer.data() + this->buffer_size);
+    this->carry_size = 0;
+  }
 
-        case 2: //Two pad characters
-          decodedBytes.push_back((temp >> 10) & 0x000000FF);
-          return decodedBytes;
+  this->flush();
+}
 
-        default:
-          return std::vector<unsigned char>(0);
-        }
-      }
+size_t Base64_Encoder :: get_written()
+{
+  return this->written;
+}
 
-      else
-      {
-        return std::vector<unsigned char>(0);
-      }
+Base64_Decoder :: Base64_Decoder(Sink output_sink, size_t chunk_size)
+{
+  this->sink = output_sink;
+  this->chunk_chars = std::max<size_t>(chunk_size - chunk_size % 4, 4);
+  this->buffer.resize((this->chunk_chars / 4) * 3);
+  this->carry_size = 0;
+  this->written = 0;
+  this->padded = false;
+  this->failed = false;
+}
 
-      cursor++;
+int Base64_Decoder :: decode(const char *input, size_t input_size)
+{
+  // Padding is valid only at the end of the whole input
+  if(this->padded)
+  {
+    this->failed = true;
+    return EXIT_FAILURE;
+  }
+
+  size_t size = 0;
+
+  if(base64Decode(std::string_view(input, input_size), this->buffer.data(), &size) == EXIT_FAILURE)
+  {
+    this->failed = true;
+    return EXIT_FAILURE;
+  }
+
+  this->padded = (input[input_size - 1] == padCharacter);
+
+  if(size > 0)
+  {
+    this->sink(this->buffer.data(), size);
+    this->written += size;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int Base64_Decoder :: update(const char *input, size_t input_size)
+{
+  if(this->failed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  while(this->carry_size > 0 && this->carry_size < 4 && input_size > 0)
+  {
+    this->carry[this->carry_size++] = *input++;
+    input_size--;
+  }
+
+  if(this->carry_size == 4)
+  {
+    this->carry_size = 0;
+
+    if(this->decode(this->carry, 4) == EXIT_FAILURE)
+    {
+      return EXIT_FAILURE;
     }
+  }
+
+  while(input_size >= 4)
+  {
+    size_t count = std::min(input_size - input_size % 4, this->chunk_chars);
 
-    decodedBytes.push_back((temp >> 16) & 0x000000FF);
-    decodedBytes.push_back((temp >> 8) & 0x000000FF);
-    decodedBytes.push_back((temp) & 0x000000FF);
+    if(this->decode(input, count) == EXIT_FAILURE)
+    {
+      return EXIT_FAILURE;
+    }
+
+    input += count;
+    input_size -= count;
   }
 
-  return decodedBytes;
+  while(input_size > 0)
+  {
+    this->carry[this->carry_size++] = *input++;
+    input_size--;
+  }
+
+  return EXIT_SUCCESS;
 }
 
-std::string Base64_get_string(const std::basic_string<char> input)
+int Base64_Decoder :: update(std::string_view input)
 {
-  std::vector<unsigned char> buffer = base64Decode(input);
-  return std::string(buffer.begin(), buffer.end());
+  return this->update(input.data(), input.size());
+}
+
+int Base64_Decoder :: finish()
+{
+  if(this->failed || this->carry_size != 0)
+  {
+    this->failed = true;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
 }
 
-std::string Base64_encode_string(std::string input)
+size_t Base64_Decoder :: get_written()
 {
-  std::vector<unsigned char> buffer;
-  std::copy(input.begin(), input.end(), std::back_inserter(buffer));
-  return base64Encode(buffer);
+  return this->written;
 }
@@ -0,0 +1,133 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Bloom_Filter.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Bloom_Filter.h>
+#include <cmath>
+#include <algorithm>
+
+// splitmix64, privateIDs are mostly sequential, so they are mixed first
+static uint64_t bloom_filter_mix(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+
+	return value ^ (value >> 31);
+}
+
+Bloom_Filter::Bloom_Filter()
+{
+	this->reset(0);
+}
+
+/*
+ * bits = -n ln(p) / ln(2)^2 rounded up to a power of two, so that the
+ * positions are masked, hashes = bits / n ln(2) for the rounded size.
+ */
+void Bloom_Filter::reset(size_t capacity, double false_positive_rate)
+{
+	false_positive_rate = std::min(std::max(false_positive_rate, 1e-9), 0.5);
+
+	double needed = -double(std::max<size_t>(capacity, 1)) * std::log(false_positive_rate) / (std::log(2.0) * std::log(2.0));
+	uint64_t size = 64;
+
+	while(double(size) < needed)
+	{
+		size <<= 1;
+	}
+
+	double hashes = double(size) / double(std::max<size_t>(capacity, 1)) * std::log(2.0);
+
+	this->hash_count = (unsigned int)std::min(std::max(std::lround(hashes), 1l), 16l);
+	this->mask = size - 1;
+	this->bits.assign(size / 64, 0);
+	this->count = 0;
+	this->capacity = capacity;
+}
+
+void Bloom_Filter::clear()
+{
+	std::fill(this->bits.begin(), this->bits.end(), 0);
+	this->count = 0;
+}
+
+void Bloom_Filter::add(uint64_t key)
+{
+	uint64_t hash = bloom_filter_mix(key);
+	uint64_t step = bloom_filter_mix(hash) | 1;
+
+	for(unsigned int i = 0; i < this->hash_count; i++)
+	{
+		uint64_t position = hash & this->mask;
+		this->bits[position >> 6] |= uint64_t(1) << (position & 63);
+		hash += step;
+	}
+
+	this->count++;
+}
+
+bool Bloom_Filter::contains(uint64_t key) const
+{
+	uint64_t hash = bloom_filter_mix(key);
+	uint64_t step = bloom_filter_mix(hash) | 1;
+
+	for(unsigned int i = 0; i < this->hash_count; i++)
+	{
+		uint64_t position = hash & this->mask;
+
+		if((this->bits[position >> 6] & (uint64_t(1) << (position & 63))) == 0)
+		{
+			return false;
+		}
+
+		hash += step;
+	}
+
+	return true;
+}
+
+size_t Bloom_Filter::get_count() const
+{
+	return this->count;
+}
+
+size_t Bloom_Filter::get_capacity() const
+{
+	return this->capacity;
+}
+
+size_t Bloom_Filter::get_memory() const
+{
+	return this->bits.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,231 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Cold_Store.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Cold_Store.h>
+#include <cstdlib>
+#include <climits>
+
+#ifdef _LZ4
+#include <lz4.h>
+#endif
+
+Cold_Store::Cold_Store()
+{
+	this->order_next = 0;
+	this->budget = 0;
+	this->memory = 0;
+	this->size = 0;
+	this->drops = 0;
+}
+
+void Cold_Store::set_budget(size_t budget)
+{
+	this->budget = budget;
+
+	while(this->memory > this->budget && this->entries.empty() == false)
+	{
+		this->drop_oldest();
+	}
+}
+
+size_t Cold_Store::get_budget() const
+{
+	return this->budget;
+}
+
+int Cold_Store::put(Type_ID privateID, std::string_view data)
+{
+	this->remove(privateID);
+
+	if(this->budget == 0 || data.size() > INT_MAX)
+	{
+		return EXIT_FAILURE;
+	}
+
+	Entry entry;
+	entry.size = data.size();
+	entry.order = this->order_next++;
+
+#ifdef _LZ4
+	entry.data.resize(LZ4_compressBound(int(data.size())));
+
+	int written = LZ4_compress_default(data.data(), &entry.data[0], int(data.size()), int(entry.data.size()));
+
+	if(written <= 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	entry.data.resize(written);
+	entry.data.shrink_to_fit();
+#else
+	entry.data.assign(data.data(), data.size());
+#endif
+
+	size_t entry_memory = entry.data.size() + sizeof(Entry);
+
+	if(entry_memory > this->budget)
+	{
+		return EXIT_FAILURE;
+	}
+
+	while(this->memory + entry_memory > this->budget && this->entries.empty() == false)
+	{
+		this->drop_oldest();
+	}
+
+	this->memory += entry_memory;
+	this->size += entry.size;
+	this->order.emplace_back(privateID, entry.order);
+	this->entries.emplace(privateID, std::move(entry));
+
+	return EXIT_SUCCESS;
+}
+
+int Cold_Store::take(Type_ID privateID, std::string &data)
+{
+	auto found = this->entries.find(privateID);
+
+	if(found == this->entries.end())
+	{
+		return EXIT_FAILURE;
+	}
+
+	const Entry &entry = found->second;
+
+#ifdef _LZ4
+	data.resize(entry.size);
+
+	int read = LZ4_decompress_safe(entry.data.data(), &data[0], int(entry.data.size()), int(entry.size));
+
+	if(read < 0 || size_t(read) != entry.size)
+	{
+		data.clear();
+		this->entry_erase(found);
+		return EXIT_FAILURE;
+	}
+#else
+	data.assign(entry.data);
+#endif
+
+	this->entry_erase(found);
+
+	return EXIT_SUCCESS;
+}
+
+bool Cold_Store::contains(Type_ID privateID) const
+{
+	return this->entries.count(privateID) != 0;
+}
+
+void Cold_Store::remove(Type_ID privateID)
+{
+	auto found = this->entries.find(privateID);
+
+	if(found != this->entries.end())
+	{
+		this->entry_erase(found);
+	}
+}
+
+void Cold_Store::clear()
+{
+	this->entries.clear();
+	this->order.clear();
+	this->memory = 0;
+	this->size = 0;
+}
+
+size_t Cold_Store::get_count() const
+{
+	return this->entries.size();
+}
+
+size_t Cold_Store::get_memory() const
+{
+	return this->memory;
+}
+
+size_t Cold_Store::get_size() const
+{
+	return this->size;
+}
+
+uint64_t Cold_Store::get_drops() const
+{
+	return this->drops;
+}
+
+void Cold_Store::entry_erase(std::unordered_map<Type_ID, Entry>::iterator entry)
+{
+	this->memory -= entry->second.data.size() + sizeof(Entry);
+	this->size -= entry->second.size;
+	this->entries.erase(entry);
+
+	// The skipped pairs are removed, when they are the most of the queue
+	if(this->order.size() > 2 * this->entries.size() + 64)
+	{
+		std::deque<std::pair<Type_ID, uint64_t>> live;
+
+		for(const auto &pair : this->order)
+		{
+			auto found = this->entries.find(pair.first);
+
+			if(found != this->entries.end() && found->second.order == pair.second)
+			{
+				live.push_back(pair);
+			}
+		}
+
+		this->order.swap(live);
+	}
+}
+
+void Cold_Store::drop_oldest()
+{
+	while(this->order.empty() == false)
+	{
+		std::pair<Type_ID, uint64_t> oldest = this->order.front();
+		this->order.pop_front();
+
+		auto found = this->entries.find(oldest.first);
+
+		if(found != this->entries.end() && found->second.order == oldest.second)
+		{
+			this->entry_erase(found);
+			this->drops++;
+			return void();
+		}
+	}
+}
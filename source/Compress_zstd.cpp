@@ -0,0 +1,342 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Compress_zstd.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Compress_zstd.h>
+
+#ifdef _ZSTD
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <zstd.h>
+#include <zdict.h>
+
+Zstd_Dictionary::Zstd_Dictionary()
+{
+	this->level = 3;
+	this->id = 0;
+	this->compress_context = nullptr;
+	this->decompress_context = nullptr;
+	this->compress_dictionary = nullptr;
+	this->decompress_dictionary = nullptr;
+}
+
+Zstd_Dictionary::~Zstd_Dictionary()
+{
+	this->clear();
+
+	ZSTD_freeCCtx(this->compress_context);
+	ZSTD_freeDCtx(this->decompress_context);
+}
+
+/*
+ * Samples are whole node documents, zstd needs some hundreds of them to
+ * find the shared content. dictionary_size is the upper limit.
+ */
+int Zstd_Dictionary::train(const std::vector<std::string> &samples, size_t dictionary_size)
+{
+	std::string buffer;
+	std::vector<size_t> sizes;
+	sizes.reserve(samples.size());
+
+	for(const std::string &sample : samples)
+	{
+		buffer.append(sample);
+		sizes.push_back(sample.size());
+	}
+
+	if(sizes.empty())
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::string dictionary(dictionary_size, '\0');
+	size_t size = ZDICT_trainFromBuffer(&dictionary[0], dictionary.size(), buffer.data(), sizes.data(), (unsigned int)sizes.size());
+
+	if(ZDICT_isError(size))
+	{
+		return EXIT_FAILURE;
+	}
+
+	dictionary.resize(size);
+
+	return this->set(dictionary);
+}
+
+// The dictionary it replaces is kept for the frames made with it
+int Zstd_Dictionary::set(std::string_view dictionary)
+{
+	this->current_clear(true);
+
+	if(dictionary.empty())
+	{
+		return EXIT_FAILURE;
+	}
+
+	this->data.assign(dictionary.data(), dictionary.size());
+	this->compress_dictionary = ZSTD_createCDict(this->data.data(), this->data.size(), this->level);
+	this->decompress_dictionary = ZSTD_createDDict(this->data.data(), this->data.size());
+
+	if(this->compress_dictionary == nullptr || this->decompress_dictionary == nullptr)
+	{
+		this->current_clear(false);
+		return EXIT_FAILURE;
+	}
+
+	this->id = ZSTD_getDictID_fromDict(this->data.data(), this->data.size());
+
+	auto found = this->previous.find(this->id);
+
+	if(found != this->previous.end())
+	{
+		ZSTD_freeDDict(found->second);
+		this->previous.erase(found);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+void Zstd_Dictionary::clear()
+{
+	this->current_clear(false);
+
+	for(auto &dictionary : this->previous)
+	{
+		ZSTD_freeDDict(dictionary.second);
+	}
+
+	this->previous.clear();
+}
+
+void Zstd_Dictionary::current_clear(bool keep_previous)
+{
+	ZSTD_freeCDict(this->compress_dictionary);
+
+	if(keep_previous && this->id != 0 && this->decompress_dictionary != nullptr)
+	{
+		this->previous[this->id] = this->decompress_dictionary;
+	}
+
+	else
+	{
+		ZSTD_freeDDict(this->decompress_dictionary);
+	}
+
+	this->compress_dictionary = nullptr;
+	this->decompress_dictionary = nullptr;
+	this->data.clear();
+	this->id = 0;
+}
+
+void Zstd_Dictionary::set_previous_path(const std::string &path)
+{
+	this->previous_path = path;
+}
+
+std::string Zstd_Dictionary::previous_file(unsigned int dictionary_id)
+{
+	return this->previous_path + std::to_string(dictionary_id) + ".zstd";
+}
+
+ZSTD_DDict_s *Zstd_Dictionary::previous_get(unsigned int dictionary_id)
+{
+	auto found = this->previous.find(dictionary_id);
+
+	if(found != this->previous.end())
+	{
+		return found->second;
+	}
+
+	ZSTD_DDict_s *dictionary = nullptr;
+
+	if(this->previous_path.empty() == false)
+	{
+		std::ifstream file(this->previous_file(dictionary_id), std::ios::binary);
+		std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		if(buffer.empty() == false && ZSTD_getDictID_fromDict(buffer.data(), buffer.size()) == dictionary_id)
+		{
+			dictionary = ZSTD_createDDict(buffer.data(), buffer.size());
+		}
+	}
+
+	this->previous[dictionary_id] = dictionary;
+
+	return dictionary;
+}
+
+int Zstd_Dictionary::file_read(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if(file.is_open() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::string dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return this->set(dictionary);
+}
+
+int Zstd_Dictionary::file_write(const std::string &path)
+{
+	if(this->is_loaded() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(this->data.data(), this->data.size());
+
+	return file.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool Zstd_Dictionary::is_loaded()
+{
+	return this->compress_dictionary != nullptr;
+}
+
+// 0 when there is no dictionary, it is stored in every frame
+unsigned int Zstd_Dictionary::get_id()
+{
+	return this->id;
+}
+
+int Zstd_Dictionary::compress(std::string_view input, std::string &output)
+{
+	if(this->contexts_create() == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	output.resize(ZSTD_compressBound(input.size()));
+	size_t size;
+
+	if(this->compress_dictionary != nullptr)
+	{
+		size = ZSTD_compress_usingCDict(this->compress_context, &output[0], output.size(), input.data(), input.size(), this->compress_dictionary);
+	}
+
+	else
+	{
+		size = ZSTD_compressCCtx(this->compress_context, &output[0], output.size(), input.data(), input.size(), this->level);
+	}
+
+	if(ZSTD_isError(size))
+	{
+		output.clear();
+		return EXIT_FAILURE;
+	}
+
+	output.resize(size);
+
+	return EXIT_SUCCESS;
+}
+
+/*
+ * The frame tells the dictionary it was made with, frames of an unknown
+ * dictionary fail instead of giving wrong data.
+ */
+int Zstd_Dictionary::decompress(std::string_view input, std::string &output)
+{
+	output.clear();
+
+	if(this->contexts_create() == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	unsigned long long content_size = ZSTD_getFrameContentSize(input.data(), input.size());
+
+	if(content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+			content_size > ZSTD_DECOMPRESS_MAX_SIZE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	unsigned int frame_id = ZSTD_getDictID_fromFrame(input.data(), input.size());
+	ZSTD_DDict_s *dictionary = nullptr;
+
+	if(frame_id != 0)
+	{
+		dictionary = frame_id == this->id ? this->decompress_dictionary : this->previous_get(frame_id);
+
+		if(dictionary == nullptr)
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	output.resize((size_t)content_size);
+	size_t size;
+
+	if(dictionary != nullptr)
+	{
+		size = ZSTD_decompress_usingDDict(this->decompress_context, &output[0], output.size(), input.data(), input.size(), dictionary);
+	}
+
+	else
+	{
+		size = ZSTD_decompressDCtx(this->decompress_context, &output[0], output.size(), input.data(), input.size());
+	}
+
+	if(ZSTD_isError(size) || size != output.size())
+	{
+		output.clear();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Zstd_Dictionary::contexts_create()
+{
+	if(this->compress_context == nullptr)
+	{
+		this->compress_context = ZSTD_createCCtx();
+	}
+
+	if(this->decompress_context == nullptr)
+	{
+		this->decompress_context = ZSTD_createDCtx();
+	}
+
+	if(this->compress_context == nullptr || this->decompress_context == nullptr)
+	{
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+#endif
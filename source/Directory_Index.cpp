@@ -0,0 +1,664 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Directory_Index.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Directory_Index.h>
+#include <Base64.h>
+#include <type_convert.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#else
+#include <filesystem>
+#endif
+
+#define DIRECTORY_INDEX_MAGIC "DIDX"
+#define DIRECTORY_INDEX_VERSION 1
+#define DIRECTORY_INDEX_JOURNAL_EXTENSION ".journal"
+// The journal is merged to the index when it grows over this or the size of the index
+#define DIRECTORY_INDEX_JOURNAL_MIN_SIZE (64 * 1024)
+
+enum Directory_Index_Record : unsigned char
+{
+	Directory_Index_Written = 1,
+	Directory_Index_Removed = 2
+};
+
+// Size and mtime of the path, EXIT_FAILURE if it does not exist
+static int directory_index_stat(const std::string &path, uint64_t *size, int64_t *mtime)
+{
+#ifdef __linux__
+	struct stat status;
+
+	if(stat(path.c_str(), &status) != 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	*size = uint64_t(status.st_size);
+	*mtime = int64_t(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#else
+	std::error_code error;
+	auto time = std::filesystem::last_write_time(path, error);
+
+	if(error)
+	{
+		return EXIT_FAILURE;
+	}
+
+	*size = std::filesystem::is_directory(path, error) ? 0 : uint64_t(std::filesystem::file_size(path, error));
+	*mtime = int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+#endif
+
+	return EXIT_SUCCESS;
+}
+
+static int directory_index_file_read(const std::string &path, std::vector<unsigned char> &data)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if(file.is_open() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	return EXIT_SUCCESS;
+}
+
+static uint64_t directory_index_file_hash(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return Directory_Index::content_hash(data);
+}
+
+/*
+ * Calls callback with the names of the files of the directory. On Linux
+ * with getdents64 in big batches, as directory_iterator stats every entry.
+ */
+template <typename Callback>
+static int directory_index_list(const std::string &directory, Callback callback)
+{
+#ifdef __linux__
+	struct Linux_Dirent64
+	{
+		uint64_t d_ino;
+		int64_t d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[1];
+	};
+
+	int descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if(descriptor < 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::vector<char> buffer(1 << 16);
+	long size;
+
+	while((size = syscall(SYS_getdents64, descriptor, buffer.data(), buffer.size())) > 0)
+	{
+		for(long offset = 0; offset < size;)
+		{
+			const Linux_Dirent64 *entry = (const Linux_Dirent64*)(buffer.data() + offset);
+			offset += entry->d_reclen;
+
+			if(entry->d_type == DT_REG || entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+			{
+				callback(std::string_view(entry->d_name));
+			}
+		}
+	}
+
+	close(descriptor);
+
+	return size == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+	std::error_code error;
+
+	for(auto &entry : std::filesystem::directory_iterator(directory, error))
+	{
+		callback(std::string_view(entry.path().filename().string()));
+	}
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+#endif
+}
+
+static void directory_index_push_string(std::vector<unsigned char> &table, std::string_view value)
+{
+	varint_push_back<uint64_t>(table, value.size());
+	table.insert(table.end(), value.begin(), value.end());
+}
+
+static int directory_index_pop_varint(const std::vector<unsigned char> &table, size_t &offset, uint64_t *value)
+{
+	size_t used = 0;
+
+	if(offset >= table.size() || varint_decode(table.data() + offset, table.size() - offset, value, &used) == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	offset += used;
+
+	return EXIT_SUCCESS;
+}
+
+static int directory_index_pop_string(const std::vector<unsigned char> &table, size_t &offset, std::string &value)
+{
+	uint64_t size = 0;
+
+	if(directory_index_pop_varint(table, offset, &size) == EXIT_FAILURE || size > table.size() - offset)
+	{
+		return EXIT_FAILURE;
+	}
+
+	value.assign((const char*)table.data() + offset, size);
+	offset += size;
+
+	return EXIT_SUCCESS;
+}
+
+// Replaces the entry of the same privateID
+static void directory_index_entry_set(std::vector<Directory_Index_Entry> &entries, Directory_Index_Entry &&entry)
+{
+	auto at = std::lower_bound(entries.begin(), entries.end(), entry.privateID, [](const Directory_Index_Entry &a, Type_ID id)
+	{
+		return a.privateID < id;
+	});
+
+	if(at != entries.end() && at->privateID == entry.privateID)
+	{
+		*at = std::move(entry);
+	}
+
+	else
+	{
+		entries.insert(at, std::move(entry));
+	}
+}
+
+static bool directory_index_entry_erase(std::vector<Directory_Index_Entry> &entries, Type_ID privateID)
+{
+	auto at = std::lower_bound(entries.begin(), entries.end(), privateID, [](const Directory_Index_Entry &a, Type_ID id)
+	{
+		return a.privateID < id;
+	});
+
+	if(at != entries.end() && at->privateID == privateID)
+	{
+		entries.erase(at);
+		return true;
+	}
+
+	return false;
+}
+
+Directory_Index::Directory_Index()
+{
+	this->scan_count = 0;
+	this->clear();
+}
+
+void Directory_Index::clear()
+{
+	this->entries.clear();
+	this->directory_mtime = 0;
+	this->directory_scanned.clear();
+	this->modified = false;
+	this->journal.clear();
+	this->file_size = 0;
+	this->journal_file_size = 0;
+}
+
+uint64_t Directory_Index::content_hash(std::string_view data)
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	for(unsigned char c : data)
+	{
+		hash = (hash ^ c) * 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+int Directory_Index::update(const std::string &directory, const std::string &prefix, const std::string &suffix)
+{
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	std::string scanned = directory + '\0' + prefix + '\0' + suffix;
+
+	if(directory_index_stat(directory, &size, &mtime) == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if(mtime == this->directory_mtime && scanned == this->directory_scanned)
+	{
+		return EXIT_SUCCESS;
+	}
+
+	std::vector<Directory_Index_Entry> found;
+
+	int status = directory_index_list(directory, [&](std::string_view name)
+	{
+		if(name.size() <= prefix.size() + suffix.size() ||
+				name.compare(0, prefix.size(), prefix) != 0 ||
+				name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+		{
+			return void();
+		}
+
+		std::string_view encoded = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+		unsigned char raw[((sizeof(Type_ID) + 2) / 3) * 3];
+		size_t raw_size = 0;
+
+		if(encoded.size() > (sizeof(raw) / 3) * 4 ||
+				base64Decode(encoded, raw, &raw_size) == EXIT_FAILURE || raw_size != sizeof(Type_ID))
+		{
+			return void();
+		}
+
+		Directory_Index_Entry entry;
+		std::memcpy(&entry.privateID, raw, sizeof(Type_ID));
+		entry.name.assign(name.data(), name.size());
+
+		if(directory_index_stat(directory + "/" + entry.name, &entry.size, &entry.mtime) == EXIT_FAILURE)
+		{
+			return void();
+		}
+
+		const Directory_Index_Entry *previous = this->find(entry.privateID);
+
+		if(previous != nullptr && previous->name == entry.name && previous->size == entry.size && previous->mtime == entry.mtime)
+		{
+			entry.hash = previous->hash;
+		}
+
+		else
+		{
+			entry.hash = directory_index_file_hash(directory + "/" + entry.name);
+		}
+
+		found.push_back(std::move(entry));
+	});
+
+	if(status == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::sort(found.begin(), found.end(), [](const Directory_Index_Entry &a, const Directory_Index_Entry &b)
+	{
+		return a.privateID < b.privateID;
+	});
+
+	this->entries.swap(found);
+	this->directory_mtime = mtime;
+	this->directory_scanned.swap(scanned);
+	this->modified = true;
+	this->scan_count++;
+	// Written whole, the records are of the old entries
+	this->journal.clear();
+
+	return EXIT_SUCCESS;
+}
+
+// Only for the own changes of a directory, which was up to date before them
+void Directory_Index::directory_touched(const std::string &directory)
+{
+	uint64_t size = 0;
+	int64_t mtime = 0;
+
+	if(this->directory_scanned.compare(0, this->directory_scanned.find('\0'), directory) != 0 ||
+			directory_index_stat(directory, &size, &mtime) == EXIT_FAILURE)
+	{
+		return void();
+	}
+
+	this->directory_mtime = mtime;
+}
+
+/*
+ * The file ends with the hash of the rest of it, a torn or foreign file
+ * is not read and the directory is scanned again. A torn record at the
+ * end of the journal is dropped and the index written again.
+ */
+int Directory_Index::file_read(const std::string &path)
+{
+	this->clear();
+
+	std::vector<unsigned char> data;
+
+	if(directory_index_file_read(path, data) == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	size_t file_size = data.size();
+	size_t offset = sizeof(DIRECTORY_INDEX_MAGIC) - 1;
+	uint64_t hash = 0;
+
+	if(data.size() < offset + sizeof(hash) || std::memcmp(data.data(), DIRECTORY_INDEX_MAGIC, offset) != 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	uchar_to_array<uint64_t>(data.data() + data.size() - sizeof(hash), sizeof(hash), &hash);
+	data.resize(data.size() - sizeof(hash));
+
+	if(hash != content_hash(std::string_view((const char*)data.data(), data.size())))
+	{
+		return EXIT_FAILURE;
+	}
+
+	uint64_t version = 0;
+	uint64_t mtime = 0;
+	uint64_t count = 0;
+	std::string scanned;
+
+	if(directory_index_pop_varint(data, offset, &version) == EXIT_FAILURE || version != DIRECTORY_INDEX_VERSION ||
+			directory_index_pop_string(data, offset, scanned) == EXIT_FAILURE ||
+			directory_index_pop_varint(data, offset, &mtime) == EXIT_FAILURE ||
+			directory_index_pop_varint(data, offset, &count) == EXIT_FAILURE || count > data.size() - offset)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Directory_Index_Entry> read(count);
+	uint64_t previous = 0;
+
+	for(Directory_Index_Entry &entry : read)
+	{
+		uint64_t delta = 0;
+		uint64_t entry_mtime = 0;
+
+		if(directory_index_pop_varint(data, offset, &delta) == EXIT_FAILURE ||
+				directory_index_pop_string(data, offset, entry.name) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry.size) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry_mtime) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry.hash) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		previous += delta;
+		entry.privateID = Type_ID(previous);
+		entry.mtime = zigzag_decode<int64_t>(entry_mtime);
+	}
+
+	this->entries.swap(read);
+	this->directory_mtime = zigzag_decode<int64_t>(mtime);
+	this->directory_scanned.swap(scanned);
+	this->file_size = file_size;
+
+	if(directory_index_file_read(path + DIRECTORY_INDEX_JOURNAL_EXTENSION, data) == EXIT_SUCCESS)
+	{
+		this->journal_file_size = data.size();
+
+		// Appending after a torn record would lose the new records
+		if(this->journal_replay(data) == EXIT_FAILURE)
+		{
+			this->file_write(path);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Directory_Index::journal_replay(const std::vector<unsigned char> &data)
+{
+	size_t offset = 0;
+
+	while(offset < data.size())
+	{
+		unsigned char record = data[offset++];
+		uint64_t privateID = 0;
+		uint64_t mtime = 0;
+
+		if(directory_index_pop_varint(data, offset, &privateID) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		if(record == Directory_Index_Removed)
+		{
+			if(directory_index_pop_varint(data, offset, &mtime) == EXIT_FAILURE)
+			{
+				return EXIT_FAILURE;
+			}
+
+			directory_index_entry_erase(this->entries, Type_ID(privateID));
+			this->directory_mtime = zigzag_decode<int64_t>(mtime);
+			continue;
+		}
+
+		Directory_Index_Entry entry;
+		uint64_t entry_mtime = 0;
+		entry.privateID = Type_ID(privateID);
+
+		if(record != Directory_Index_Written ||
+				directory_index_pop_string(data, offset, entry.name) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry.size) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry_mtime) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &entry.hash) == EXIT_FAILURE ||
+				directory_index_pop_varint(data, offset, &mtime) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		entry.mtime = zigzag_decode<int64_t>(entry_mtime);
+		directory_index_entry_set(this->entries, std::move(entry));
+		this->directory_mtime = zigzag_decode<int64_t>(mtime);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Directory_Index::file_write(const std::string &path)
+{
+	std::string journal_path = path + DIRECTORY_INDEX_JOURNAL_EXTENSION;
+	uint64_t size = 0;
+	int64_t mtime = 0;
+
+	// Made first, as making them changes the mtime of the directory
+	if(directory_index_stat(path, &size, &mtime) == EXIT_FAILURE || directory_index_stat(journal_path, &size, &mtime) == EXIT_FAILURE)
+	{
+		std::ofstream(path, std::ios::binary | std::ios::app).close();
+		std::ofstream(journal_path, std::ios::binary | std::ios::app).close();
+		this->directory_touched(path.substr(0, path.find_last_of('/')));
+	}
+
+	std::vector<unsigned char> data(DIRECTORY_INDEX_MAGIC, DIRECTORY_INDEX_MAGIC + sizeof(DIRECTORY_INDEX_MAGIC) - 1);
+	varint_push_back<uint64_t>(data, DIRECTORY_INDEX_VERSION);
+	directory_index_push_string(data, this->directory_scanned);
+	varint_push_back<uint64_t>(data, zigzag_encode<int64_t>(this->directory_mtime));
+	varint_push_back<uint64_t>(data, this->entries.size());
+
+	uint64_t previous = 0;
+
+	for(const Directory_Index_Entry &entry : this->entries)
+	{
+		varint_push_back<uint64_t>(data, uint64_t(entry.privateID) - previous);
+		directory_index_push_string(data, entry.name);
+		varint_push_back<uint64_t>(data, entry.size);
+		varint_push_back<uint64_t>(data, zigzag_encode<int64_t>(entry.mtime));
+		varint_push_back<uint64_t>(data, entry.hash);
+
+		previous = uint64_t(entry.privateID);
+	}
+
+	uint64_t hash = content_hash(std::string_view((const char*)data.data(), data.size()));
+	unsigned char hash_data[sizeof(hash)];
+	array_to_uchar<uint64_t>(&hash, 1, hash_data);
+	data.insert(data.end(), hash_data, hash_data + sizeof(hash));
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write((const char*)data.data(), data.size());
+	file.close();
+
+	if(file.fail())
+	{
+		return EXIT_FAILURE;
+	}
+
+	// Emptied, not removed, so that the mtime of the directory stays
+	std::ofstream journal_file(journal_path, std::ios::binary | std::ios::trunc);
+	journal_file.close();
+
+	if(journal_file.fail())
+	{
+		return EXIT_FAILURE;
+	}
+
+	this->modified = false;
+	this->journal.clear();
+	this->file_size = data.size();
+	this->journal_file_size = 0;
+
+	return EXIT_SUCCESS;
+}
+
+int Directory_Index::file_update(const std::string &path)
+{
+	if(this->modified || this->file_size == 0 ||
+			this->journal_file_size + this->journal.size() > std::max<size_t>(this->file_size, DIRECTORY_INDEX_JOURNAL_MIN_SIZE))
+	{
+		return this->file_write(path);
+	}
+
+	if(this->journal.empty())
+	{
+		return EXIT_SUCCESS;
+	}
+
+	std::ofstream file(path + DIRECTORY_INDEX_JOURNAL_EXTENSION, std::ios::binary | std::ios::app);
+	file.write((const char*)this->journal.data(), this->journal.size());
+	file.close();
+
+	if(file.fail())
+	{
+		return EXIT_FAILURE;
+	}
+
+	this->journal_file_size += this->journal.size();
+	this->journal.clear();
+
+	return EXIT_SUCCESS;
+}
+
+void Directory_Index::file_written(const std::string &directory, const std::string &name, Type_ID privateID, std::string_view content)
+{
+	Directory_Index_Entry entry;
+	entry.privateID = privateID;
+	entry.name = name;
+	entry.hash = content_hash(content);
+
+	if(directory_index_stat(directory + "/" + name, &entry.size, &entry.mtime) == EXIT_FAILURE)
+	{
+		return void();
+	}
+
+	this->directory_touched(directory);
+
+	this->journal.push_back(Directory_Index_Written);
+	varint_push_back<uint64_t>(this->journal, uint64_t(privateID));
+	directory_index_push_string(this->journal, entry.name);
+	varint_push_back<uint64_t>(this->journal, entry.size);
+	varint_push_back<uint64_t>(this->journal, zigzag_encode<int64_t>(entry.mtime));
+	varint_push_back<uint64_t>(this->journal, entry.hash);
+	varint_push_back<uint64_t>(this->journal, zigzag_encode<int64_t>(this->directory_mtime));
+
+	directory_index_entry_set(this->entries, std::move(entry));
+}
+
+void Directory_Index::file_removed(const std::string &directory, Type_ID privateID)
+{
+	if(directory_index_entry_erase(this->entries, privateID) == false)
+	{
+		return void();
+	}
+
+	this->directory_touched(directory);
+
+	this->journal.push_back(Directory_Index_Removed);
+	varint_push_back<uint64_t>(this->journal, uint64_t(privateID));
+	varint_push_back<uint64_t>(this->journal, zigzag_encode<int64_t>(this->directory_mtime));
+}
+
+const std::vector<Directory_Index_Entry> &Directory_Index::get_entries() const
+{
+	return this->entries;
+}
+
+const Directory_Index_Entry *Directory_Index::find(Type_ID privateID) const
+{
+	auto at = std::lower_bound(this->entries.begin(), this->entries.end(), privateID, [](const Directory_Index_Entry &a, Type_ID id)
+	{
+		return a.privateID < id;
+	});
+
+	if(at != this->entries.end() && at->privateID == privateID)
+	{
+		return &*at;
+	}
+
+	return nullptr;
+}
+
+bool Directory_Index::is_modified() const
+{
+	return this->modified || this->journal.empty() == false;
+}
+
+uint64_t Directory_Index::get_scan_count() const
+{
+	return this->scan_count;
+}
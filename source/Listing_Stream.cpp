@@ -0,0 +1,453 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Listing_Stream.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Listing_Stream.h>
+
+#if defined(_ZLIB) || defined(_ZSTD)
+#include <type_convert.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _ZSTD
+#include <zstd.h>
+#endif
+
+#define LISTING_STREAM_HEADER_SIZE 8
+#define LISTING_STREAM_FOOTER_SIZE 20
+#define LISTING_STREAM_FRAME_SIZE 16
+#define LISTING_STREAM_ENTRY_SIZE 20
+// Upper limit of one uncompressed frame, larger ones are taken as corrupted
+#define LISTING_STREAM_FRAME_MAX (1u << 30)
+
+template <typename Type>
+static void stream_put(std::string &buffer, Type value)
+{
+	unsigned char bytes[sizeof(Type)];
+	array_to_uchar<Type>(&value, 1, bytes, true);
+
+	buffer.append((const char*)bytes, sizeof(Type));
+}
+
+template <typename Type>
+static Type stream_get(const unsigned char *data)
+{
+	Type value;
+	uchar_to_array<Type>(data, sizeof(Type), &value, true);
+
+	return value;
+}
+
+static int stream_compress(unsigned char codec, const std::string &input, std::string &output)
+{
+#ifdef _ZSTD
+	if(codec == LISTING_STREAM_CODEC_ZSTD)
+	{
+		output.resize(ZSTD_compressBound(input.size()));
+		size_t size = ZSTD_compress(&output[0], output.size(), input.data(), input.size(), 3);
+
+		if(ZSTD_isError(size))
+		{
+			return EXIT_FAILURE;
+		}
+
+		output.resize(size);
+		return EXIT_SUCCESS;
+	}
+#endif
+
+#ifdef _ZLIB
+	if(codec == LISTING_STREAM_CODEC_ZLIB)
+	{
+		uLongf size = compressBound((uLong)input.size());
+		output.resize(size);
+
+		if(compress2((Bytef*)&output[0], &size, (const Bytef*)input.data(), (uLong)input.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+		{
+			return EXIT_FAILURE;
+		}
+
+		output.resize(size);
+		return EXIT_SUCCESS;
+	}
+#endif
+
+	return EXIT_FAILURE;
+}
+
+static int stream_decompress(unsigned char codec, const std::string &input, size_t size, std::string &output)
+{
+	output.resize(size);
+
+	if(size == 0)
+	{
+		return EXIT_SUCCESS;
+	}
+
+#ifdef _ZSTD
+	if(codec == LISTING_STREAM_CODEC_ZSTD)
+	{
+		size_t written = ZSTD_decompress(&output[0], output.size(), input.data(), input.size());
+
+		return (ZSTD_isError(written) || written != size) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+#endif
+
+#ifdef _ZLIB
+	if(codec == LISTING_STREAM_CODEC_ZLIB)
+	{
+		uLongf written = (uLongf)size;
+
+		if(uncompress((Bytef*)&output[0], &written, (const Bytef*)input.data(), (uLong)input.size()) != Z_OK)
+		{
+			return EXIT_FAILURE;
+		}
+
+		return written != size ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+#endif
+
+	return EXIT_FAILURE;
+}
+
+Listing_Stream_Writer::Listing_Stream_Writer(size_t frame_size)
+{
+	this->frame_size = frame_size;
+	this->position = 0;
+	this->failed = false;
+#ifdef _ZSTD
+	this->codec = LISTING_STREAM_CODEC_ZSTD;
+#else
+	this->codec = LISTING_STREAM_CODEC_ZLIB;
+#endif
+}
+
+int Listing_Stream_Writer::open(const std::string &path)
+{
+	this->file.open(path, std::ios::binary | std::ios::trunc);
+
+	if(this->file.is_open() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::string header("LSTM");
+	header.push_back((char)LISTING_STREAM_VERSION);
+	header.push_back((char)this->codec);
+	header.append(2, '\0');
+
+	this->file.write(header.data(), header.size());
+	this->position = header.size();
+	this->frames.clear();
+	this->entries.clear();
+	this->frame.clear();
+	this->failed = this->file.good() == false;
+
+	return this->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int Listing_Stream_Writer::append(std::string_view xml, uint64_t key)
+{
+	if(this->failed || xml.size() > LISTING_STREAM_FRAME_MAX)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if(this->frame.empty() == false && this->frame.size() + xml.size() > this->frame_size)
+	{
+		if(this->frame_flush() == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(key != 0)
+	{
+		Listing_Stream_Entry entry;
+		entry.key = key;
+		entry.frame = (uint32_t)this->frames.size();
+		entry.offset = (uint32_t)this->frame.size();
+		entry.size = (uint32_t)xml.size();
+
+		this->entries.push_back(entry);
+	}
+
+	this->frame.append(xml.data(), xml.size());
+
+	return EXIT_SUCCESS;
+}
+
+int Listing_Stream_Writer::frame_flush()
+{
+	if(stream_compress(this->codec, this->frame, this->compressed) == EXIT_FAILURE)
+	{
+		this->failed = true;
+		return EXIT_FAILURE;
+	}
+
+	Listing_Stream_Frame frame_info;
+	frame_info.offset = this->position;
+	frame_info.compressed_size = (uint32_t)this->compressed.size();
+	frame_info.size = (uint32_t)this->frame.size();
+
+	this->frames.push_back(frame_info);
+	this->file.write(this->compressed.data(), this->compressed.size());
+	this->position += this->compressed.size();
+	this->frame.clear();
+
+	if(this->file.good() == false)
+	{
+		this->failed = true;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Listing_Stream_Writer::close()
+{
+	if(this->failed == false && this->frame.empty() == false)
+	{
+		this->frame_flush();
+	}
+
+	if(this->failed)
+	{
+		this->file.close();
+		return EXIT_FAILURE;
+	}
+
+	std::sort(this->entries.begin(), this->entries.end(), [](const Listing_Stream_Entry &a, const Listing_Stream_Entry &b)
+	{
+		return a.key < b.key;
+	});
+
+	std::string tables;
+	tables.reserve(this->frames.size() * LISTING_STREAM_FRAME_SIZE + this->entries.size() * LISTING_STREAM_ENTRY_SIZE + LISTING_STREAM_FOOTER_SIZE);
+
+	for(const Listing_Stream_Frame &frame_info : this->frames)
+	{
+		stream_put<uint64_t>(tables, frame_info.offset);
+		stream_put<uint32_t>(tables, frame_info.compressed_size);
+		stream_put<uint32_t>(tables, frame_info.size);
+	}
+
+	for(const Listing_Stream_Entry &entry : this->entries)
+	{
+		stream_put<uint64_t>(tables, entry.key);
+		stream_put<uint32_t>(tables, entry.frame);
+		stream_put<uint32_t>(tables, entry.offset);
+		stream_put<uint32_t>(tables, entry.size);
+	}
+
+	stream_put<uint64_t>(tables, this->position);
+	stream_put<uint32_t>(tables, (uint32_t)this->frames.size());
+	stream_put<uint32_t>(tables, (uint32_t)this->entries.size());
+	tables.append("LSTE");
+
+	this->file.write(tables.data(), tables.size());
+	this->file.close();
+
+	return this->file.fail() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+Listing_Stream_Reader::Listing_Stream_Reader()
+{
+	this->frame_index = (size_t)-1;
+	this->codec = 0;
+}
+
+int Listing_Stream_Reader::open(const std::string &path)
+{
+	this->close();
+	this->file.open(path, std::ios::binary);
+
+	if(this->file.is_open() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	unsigned char header[LISTING_STREAM_HEADER_SIZE];
+	unsigned char footer[LISTING_STREAM_FOOTER_SIZE];
+
+	this->file.seekg(0, std::ios::end);
+	uint64_t file_size = (uint64_t)this->file.tellg();
+
+	if(file_size < LISTING_STREAM_HEADER_SIZE + LISTING_STREAM_FOOTER_SIZE)
+	{
+		this->close();
+		return EXIT_FAILURE;
+	}
+
+	this->file.seekg(0);
+	this->file.read((char*)header, sizeof(header));
+	this->file.seekg(file_size - sizeof(footer));
+	this->file.read((char*)footer, sizeof(footer));
+
+	uint64_t tables_offset = stream_get<uint64_t>(footer);
+	uint64_t frame_count = stream_get<uint32_t>(footer + 8);
+	uint64_t entry_count = stream_get<uint32_t>(footer + 12);
+	uint64_t tables_size = frame_count * LISTING_STREAM_FRAME_SIZE + entry_count * LISTING_STREAM_ENTRY_SIZE;
+
+	if(this->file.good() == false ||
+	   std::memcmp(header, "LSTM", 4) != 0 || header[4] != LISTING_STREAM_VERSION ||
+	   std::memcmp(footer + 16, "LSTE", 4) != 0 ||
+	   tables_offset < LISTING_STREAM_HEADER_SIZE || tables_offset + tables_size + sizeof(footer) != file_size)
+	{
+		this->close();
+		return EXIT_FAILURE;
+	}
+
+	this->codec = header[5];
+
+	std::string tables(tables_size, '\0');
+	this->file.seekg(tables_offset);
+	this->file.read(&tables[0], tables.size());
+
+	if(this->file.good() == false)
+	{
+		this->close();
+		return EXIT_FAILURE;
+	}
+
+	const unsigned char *data = (const unsigned char*)tables.data();
+	this->frames.resize(frame_count);
+	this->entries.resize(entry_count);
+
+	for(Listing_Stream_Frame &frame_info : this->frames)
+	{
+		frame_info.offset = stream_get<uint64_t>(data);
+		frame_info.compressed_size = stream_get<uint32_t>(data + 8);
+		frame_info.size = stream_get<uint32_t>(data + 12);
+		data += LISTING_STREAM_FRAME_SIZE;
+
+		if(frame_info.offset < LISTING_STREAM_HEADER_SIZE || frame_info.offset + frame_info.compressed_size > tables_offset ||
+		   frame_info.size > LISTING_STREAM_FRAME_MAX)
+		{
+			this->close();
+			return EXIT_FAILURE;
+		}
+	}
+
+	for(Listing_Stream_Entry &entry : this->entries)
+	{
+		entry.key = stream_get<uint64_t>(data);
+		entry.frame = stream_get<uint32_t>(data + 8);
+		entry.offset = stream_get<uint32_t>(data + 12);
+		entry.size = stream_get<uint32_t>(data + 16);
+		data += LISTING_STREAM_ENTRY_SIZE;
+
+		if(entry.frame >= frame_count || (uint64_t)entry.offset + entry.size > this->frames[entry.frame].size)
+		{
+			this->close();
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+void Listing_Stream_Reader::close()
+{
+	if(this->file.is_open())
+	{
+		this->file.close();
+	}
+
+	this->file.clear();
+	this->frames.clear();
+	this->entries.clear();
+	this->frame.clear();
+	this->frame_index = (size_t)-1;
+}
+
+size_t Listing_Stream_Reader::get_frame_count()
+{
+	return this->frames.size();
+}
+
+int Listing_Stream_Reader::frame_read(size_t index, std::string &xml)
+{
+	if(index >= this->frames.size())
+	{
+		return EXIT_FAILURE;
+	}
+
+	const Listing_Stream_Frame &frame_info = this->frames[index];
+
+	this->compressed.resize(frame_info.compressed_size);
+	this->file.seekg(frame_info.offset);
+	this->file.read(&this->compressed[0], this->compressed.size());
+
+	if(this->file.good() == false)
+	{
+		this->file.clear();
+		return EXIT_FAILURE;
+	}
+
+	return stream_decompress(this->codec, this->compressed, frame_info.size, xml);
+}
+
+int Listing_Stream_Reader::find(uint64_t key, std::string &xml)
+{
+	auto found = std::lower_bound(this->entries.begin(), this->entries.end(), key, [](const Listing_Stream_Entry &entry, uint64_t value)
+	{
+		return entry.key < value;
+	});
+
+	if(found == this->entries.end() || found->key != key)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if(this->frame_index != found->frame)
+	{
+		if(this->frame_read(found->frame, this->frame) == EXIT_FAILURE)
+		{
+			this->frame_index = (size_t)-1;
+			return EXIT_FAILURE;
+		}
+
+		this->frame_index = found->frame;
+	}
+
+	xml.assign(this->frame, found->offset, found->size);
+
+	return EXIT_SUCCESS;
+}
+#endif
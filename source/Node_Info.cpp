@@ -35,6 +35,9 @@
 #include <Common_Types.h>
 
 #include <string>
+#include <utility>
+#include <cstddef>
+#include <atomic>
 #include <Sync_Table.h>
 
 #ifdef _XML_SUPPORT
@@ -46,8 +49,117 @@
 
 #include <Node_Info.h>
 
+uint64_t node_modified_stamp_next()
+{
+	static std::atomic<uint64_t> counter(0);
+
+	return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+size_t string_memory_size(const std::string &value)
+{
+	const char *data = value.data();
+
+	if(data >= (const char*)&value && data < (const char*)(&value + 1))
+	{
+		return 0;
+	}
+
+	return value.capacity() + 1;
+}
+
+#ifdef _NODE_INFO_COMPACT
+size_t string_memory_size(const Interned_String &value)
+{
+	if(value.empty())
+	{
+		return 0;
+	}
+
+	return offsetof(String_Pool_Entry, data) + value.size() + 1;
+}
+
+static void node_info_set(Node_Info_String &target, std::string_view value, String_Pool *pool)
+{
+	if(pool == nullptr)
+	{
+		pool = String_Pool::get_default();
+	}
+
+	target = pool->intern(value);
+	// The old value may have been the last reference of its entry
+	pool->collect_needed();
+}
+
+// Strings of an other pool are interned again, the source pool may be gone before target
+static void node_info_copy(Node_Info_String &target, String_Pool *target_pool, const Node_Info_String &source, String_Pool *source_pool)
+{
+	if(target_pool == nullptr)
+	{
+		target_pool = String_Pool::get_default();
+	}
+
+	if(source_pool == nullptr)
+	{
+		source_pool = String_Pool::get_default();
+	}
+
+	if(target_pool == source_pool || source.empty())
+	{
+		target = source;
+		return void();
+	}
+
+	node_info_set(target, source.view(), target_pool);
+}
+
+void Node_Info :: set_name(std::string_view value)
+{
+	node_info_set(this->name, value, this->pool);
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: set_info(std::string_view value)
+{
+	node_info_set(this->info, value, this->pool);
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: set_memo(std::string_view value)
+{
+	node_info_set(this->memo, value, this->pool);
+	this->modified_stamp = node_modified_stamp_next();
+}
+
 void Node_Info :: clear()
 {
+	this->modified_stamp = node_modified_stamp_next();
+	this->info.clear();
+	this->memo.clear();
+	this->name.clear();
+}
+#else
+void Node_Info :: set_name(std::string_view value)
+{
+	this->name.assign(value.data(), value.size());
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: set_info(std::string_view value)
+{
+	this->info.assign(value.data(), value.size());
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: set_memo(std::string_view value)
+{
+	this->memo.assign(value.data(), value.size());
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: clear()
+{
+	this->modified_stamp = node_modified_stamp_next();
 	this->info.clear();
 	this->info.shrink_to_fit();
 	this->memo.clear();
@@ -55,23 +167,54 @@ void Node_Info :: clear()
 	this->name.clear();
 	this->name.shrink_to_fit();
 }
+#endif
+
+size_t Node_Info :: memory_size() const
+{
+	return string_memory_size(this->name) + string_memory_size(this->info) + string_memory_size(this->memo);
+}
 
 void Node_Info :: copy_to(Node_Info *to)
 {
-	to->info = this->info;
-	to->memo = this->memo;
-	to->name = this->name;
+	to->copy_from(this);
 }
 
 void Node_Info :: copy_from(Node_Info *from)
 {
+#ifdef _NODE_INFO_COMPACT
+	node_info_copy(this->info, this->pool, from->info, from->pool);
+	node_info_copy(this->memo, this->pool, from->memo, from->pool);
+	node_info_copy(this->name, this->pool, from->name, from->pool);
+#else
 	this->info = from->info;
 	this->memo = from->memo;
 	this->name = from->name;
+#endif
+	this->modified_stamp = node_modified_stamp_next();
+}
+
+void Node_Info :: move_to(Node_Info *to)
+{
+	to->move_from(this);
+}
+
+void Node_Info :: move_from(Node_Info *from)
+{
+	if(from == this)
+	{
+		return void();
+	}
+
+	this->info = std::move(from->info);
+	this->memo = std::move(from->memo);
+	this->name = std::move(from->name);
+	this->modified_stamp = node_modified_stamp_next();
+
+	from->clear();
 }
 
 
-int Node_Info :: xml_parse(tinyxml2::XMLElement *element)
+int Node_Info :: xml_parse(tinyxml2::XMLElement *element, unsigned int fields)
 {
 	std::string name = element->Value();
 
@@ -81,25 +224,48 @@ int Node_Info :: xml_parse(tinyxml2::XMLElement *element)
 	}
 
 	tinyxml2::XMLElement *element_child = element->FirstChildElement();
+#ifdef _NODE_INFO_COMPACT
+	std::string buffer;
+#endif
 
 	while(element_child != nullptr)
 	{
 		name = element_child->Value();
 
-		if(name == XML_STRING_NAME)
+#ifdef _NODE_INFO_COMPACT
+		if(name == XML_STRING_NAME && (fields & Node_Fields::Name))
+		{
+			base64Decode(get_string_view(element_child), buffer);
+			this->set_name(buffer);
+		}
+
+		else if(name == XML_STRING_INFO && (fields & Node_Fields::Info))
+		{
+			base64Decode(get_string_view(element_child), buffer);
+			this->set_info(buffer);
+		}
+
+		else if(name == XML_STRING_MEMO && (fields & Node_Fields::Memo))
 		{
-			this->name = Base64_get_string(get_std_string(element_child));
+			base64Decode(get_string_view(element_child), buffer);
+			this->set_memo(buffer);
+		}
+#else
+		if(name == XML_STRING_NAME && (fields & Node_Fields::Name))
+		{
+			base64Decode(get_string_view(element_child), this->name);
 		}
 
-		else if(name == XML_STRING_INFO)
+		else if(name == XML_STRING_INFO && (fields & Node_Fields::Info))
 		{
-			this->info = Base64_get_string(get_std_string(element_child));
+			base64Decode(get_string_view(element_child), this->info);
 		}
 
-		else if(name == XML_STRING_MEMO)
+		else if(name == XML_STRING_MEMO && (fields & Node_Fields::Memo))
 		{
-			this->memo = Base64_get_string(get_std_string(element_child));
+			base64Decode(get_string_view(element_child), this->memo);
 		}
+#endif
 
 		name.clear();
 		element_child = element_child->NextSiblingElement();
@@ -115,21 +281,21 @@ void Node_Info :: xml_create(tinyxml2::XMLPrinter *printer, XML_Options_Table &o
 	if(!this->info.empty())
 	{
 		printer->OpenElement(XML_STRING_INFO, options.no_empty_space);
-		printer->PushText(Base64_encode_string(this->info).c_str());
+		base64_print(this->info, printer);
 		printer->CloseElement(options.no_empty_space);
 	}
 
 	if(!this->name.empty())
 	{
 		printer->OpenElement(XML_STRING_NAME, options.no_empty_space);
-		printer->PushText(Base64_encode_string(this->name).c_str());
+		base64_print(this->name, printer);
 		printer->CloseElement(options.no_empty_space);
 	}
 
 	if(!this->memo.empty())
 	{
 		printer->OpenElement(XML_STRING_MEMO, options.no_empty_space);
-		printer->PushText(Base64_encode_string(this->memo).c_str());
+		base64_print(this->memo, printer);
 		printer->CloseElement(options.no_empty_space);
 	}
 
@@ -0,0 +1,421 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/String_Pool.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <String_Pool.h>
+
+#include <cstring>
+#include <new>
+#include <algorithm>
+
+// Entries are rounded up to size classes of 16 bytes, larger ones are allocated on their own
+#define STRING_POOL_CLASS_SIZE 16
+#define STRING_POOL_CLASS_COUNT 16
+// collect_needed() runs collect() after this many entries lost their last reference, or a quarter of the table
+#define STRING_POOL_COLLECT_MIN 1024
+
+struct String_Pool_Storage
+{
+	// The pool and the entries with references
+	std::atomic<size_t> users;
+	std::vector<char*> blocks;
+	// Entries left with only the reference of the pool, since the last collect()
+	std::atomic<size_t> unreferenced;
+};
+
+static size_t entry_size(size_t size)
+{
+	size_t bytes = offsetof(String_Pool_Entry, data) + size + 1;
+
+	return (bytes + STRING_POOL_CLASS_SIZE - 1) / STRING_POOL_CLASS_SIZE * STRING_POOL_CLASS_SIZE;
+}
+
+static void storage_release(String_Pool_Storage *storage)
+{
+	if(storage->users.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		for(char *block : storage->blocks)
+		{
+			::operator delete(block);
+		}
+
+		delete storage;
+	}
+}
+
+// The last reference of an entry of a pool, which is gone already
+static void entry_release(String_Pool_Entry *entry)
+{
+	String_Pool_Storage *storage = entry->storage;
+
+	entry->references.~atomic();
+
+	if(entry_size(entry->size) > STRING_POOL_CLASS_SIZE * STRING_POOL_CLASS_COUNT)
+	{
+		::operator delete(entry);
+	}
+
+	storage_release(storage);
+}
+
+Interned_String::Interned_String()
+{
+	this->entry = nullptr;
+}
+
+Interned_String::Interned_String(String_Pool_Entry *entry)
+{
+	this->entry = entry;
+}
+
+Interned_String::Interned_String(const Interned_String &other)
+{
+	this->entry = other.entry;
+
+	if(this->entry != nullptr)
+	{
+		this->entry->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+Interned_String::Interned_String(Interned_String &&other) noexcept
+{
+	this->entry = other.entry;
+	other.entry = nullptr;
+}
+
+Interned_String::~Interned_String()
+{
+	this->clear();
+}
+
+Interned_String &Interned_String::operator=(const Interned_String &other)
+{
+	if(this->entry != other.entry)
+	{
+		this->clear();
+		this->entry = other.entry;
+
+		if(this->entry != nullptr)
+		{
+			this->entry->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	return *this;
+}
+
+Interned_String &Interned_String::operator=(Interned_String &&other) noexcept
+{
+	if(this != &other)
+	{
+		this->clear();
+		this->entry = other.entry;
+		other.entry = nullptr;
+	}
+
+	return *this;
+}
+
+const char *Interned_String::c_str() const
+{
+	return this->entry != nullptr ? this->entry->data : "";
+}
+
+const char *Interned_String::data() const
+{
+	return this->c_str();
+}
+
+size_t Interned_String::size() const
+{
+	return this->entry != nullptr ? this->entry->size : 0;
+}
+
+bool Interned_String::empty() const
+{
+	return this->entry == nullptr;
+}
+
+void Interned_String::clear()
+{
+	if(this->entry != nullptr)
+	{
+		uint32_t references = this->entry->references.fetch_sub(1, std::memory_order_acq_rel);
+
+		if(references == 1)
+		{
+			entry_release(this->entry);
+		}
+
+		else if(references == 2)
+		{
+			this->entry->storage->unreferenced.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		this->entry = nullptr;
+	}
+}
+
+std::string_view Interned_String::view() const
+{
+	return std::string_view(this->c_str(), this->size());
+}
+
+Interned_String::operator std::string_view() const
+{
+	return this->view();
+}
+
+// Entries of different pools can hold the same text
+bool Interned_String::operator==(const Interned_String &other) const
+{
+	return this->entry == other.entry || this->view() == other.view();
+}
+
+bool Interned_String::operator!=(const Interned_String &other) const
+{
+	return !(*this == other);
+}
+
+bool operator==(const Interned_String &a, std::string_view b)
+{
+	return a.view() == b;
+}
+
+bool operator==(std::string_view a, const Interned_String &b)
+{
+	return a == b.view();
+}
+
+bool operator!=(const Interned_String &a, std::string_view b)
+{
+	return a.view() != b;
+}
+
+bool operator!=(std::string_view a, const Interned_String &b)
+{
+	return a != b.view();
+}
+
+// block_size is at least the largest size class
+String_Pool::String_Pool(size_t block_size)
+{
+	this->block_position = nullptr;
+	this->block_left = 0;
+	this->block_size = std::max<size_t>(block_size, STRING_POOL_CLASS_SIZE * STRING_POOL_CLASS_COUNT);
+	this->memory = 0;
+	this->free_lists.resize(STRING_POOL_CLASS_COUNT + 1);
+	this->storage = new String_Pool_Storage;
+	this->storage->users.store(1, std::memory_order_relaxed);
+	this->storage->unreferenced.store(0, std::memory_order_relaxed);
+}
+
+// The entries still referenced are freed with their last Interned_String
+String_Pool::~String_Pool()
+{
+	for(auto &item : this->table)
+	{
+		if(item.second->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			entry_release(item.second);
+		}
+	}
+
+	storage_release(this->storage);
+}
+
+Interned_String String_Pool::intern(std::string_view value)
+{
+	if(value.empty())
+	{
+		return Interned_String();
+	}
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	auto found = this->table.find(value);
+
+	if(found != this->table.end())
+	{
+		// The count may be 1 here, collect() can not run at the same time
+		if(found->second->references.fetch_add(1, std::memory_order_relaxed) == 1)
+		{
+			this->storage->unreferenced.fetch_sub(1, std::memory_order_relaxed);
+		}
+		return Interned_String(found->second);
+	}
+
+	String_Pool_Entry *entry = (String_Pool_Entry*)this->allocate(entry_size(value.size()));
+	// The one of the pool and the one returned
+	new (&entry->references) std::atomic<uint32_t>(2);
+	entry->size = (uint32_t)value.size();
+	entry->storage = this->storage;
+	this->storage->users.fetch_add(1, std::memory_order_relaxed);
+	std::memcpy(entry->data, value.data(), value.size());
+	entry->data[value.size()] = '\0';
+
+	this->table.emplace(std::string_view(entry->data, value.size()), entry);
+
+	return Interned_String(entry);
+}
+
+size_t String_Pool::collect()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->collect_locked();
+}
+
+// The count is a hint, it may be off while other threads release strings
+size_t String_Pool::collect_needed()
+{
+	size_t unreferenced = this->storage->unreferenced.load(std::memory_order_relaxed);
+
+	if(unreferenced < STRING_POOL_COLLECT_MIN)
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	if(unreferenced < this->table.size() / 4)
+	{
+		return 0;
+	}
+
+	return this->collect_locked();
+}
+
+size_t String_Pool::collect_locked()
+{
+	size_t freed = 0;
+
+	this->storage->unreferenced.store(0, std::memory_order_relaxed);
+
+	for(auto item = this->table.begin(); item != this->table.end();)
+	{
+		String_Pool_Entry *entry = item->second;
+
+		// Only the reference of the pool is left
+		if(entry->references.load(std::memory_order_acquire) == 1)
+		{
+			freed += entry_size(entry->size);
+			item = this->table.erase(item);
+			this->release(entry);
+			this->storage->users.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		else
+		{
+			item++;
+		}
+	}
+
+	return freed;
+}
+
+size_t String_Pool::get_count()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->table.size();
+}
+
+size_t String_Pool::get_memory()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->memory;
+}
+
+String_Pool *String_Pool::get_default()
+{
+	static String_Pool pool;
+
+	return &pool;
+}
+
+void *String_Pool::allocate(size_t size)
+{
+	size_t size_class = size / STRING_POOL_CLASS_SIZE;
+
+	if(size_class > STRING_POOL_CLASS_COUNT)
+	{
+		this->memory += size;
+		return ::operator new(size);
+	}
+
+	std::vector<void*> &free_list = this->free_lists[size_class];
+
+	if(free_list.empty() == false)
+	{
+		void *space = free_list.back();
+		free_list.pop_back();
+
+		return space;
+	}
+
+	if(this->block_left < size)
+	{
+		char *block = (char*)::operator new(this->block_size);
+
+		this->storage->blocks.push_back(block);
+		this->block_position = block;
+		this->block_left = this->block_size;
+		this->memory += this->block_size;
+	}
+
+	void *space = this->block_position;
+	this->block_position += size;
+	this->block_left -= size;
+
+	return space;
+}
+
+void String_Pool::release(String_Pool_Entry *entry)
+{
+	size_t size = entry_size(entry->size);
+	size_t size_class = size / STRING_POOL_CLASS_SIZE;
+
+	entry->references.~atomic();
+
+	if(size_class > STRING_POOL_CLASS_COUNT)
+	{
+		this->memory -= size;
+		::operator delete(entry);
+		return void();
+	}
+
+	this->free_lists[size_class].push_back(entry);
+}
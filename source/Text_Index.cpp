@@ -0,0 +1,506 @@
+/*
+ * License : BSD 3-Clause "New" or "Revised" License
+ * File : libTemplates/source/Text_Index.cpp
+ *
+ * #Copyright 2023 Mika Manninen <mika.mannin@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    (1) Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ *    (2) Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.  
+ *    
+ *    (3)The name of the author may not be used to
+ *    endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include <Text_Index.h>
+#include <type_convert.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#define TEXT_INDEX_MAGIC "TIDX"
+#define TEXT_INDEX_VERSION 1
+#define TEXT_INDEX_JOURNAL_EXTENSION ".journal"
+// The journal is merged to the index when it grows over this or the size of the index
+#define TEXT_INDEX_JOURNAL_MIN_SIZE (1024 * 1024)
+
+enum Text_Index_Record : unsigned char
+{
+	Text_Index_Update = 1,
+	Text_Index_Remove = 2
+};
+
+static void text_index_push_varint(std::vector<unsigned char> &table, uint64_t value)
+{
+	unsigned char buffer[VARINT_MAX_SIZE];
+	table.insert(table.end(), buffer, buffer + varint_encode(value, buffer));
+}
+
+static int text_index_pop_varint(const std::vector<unsigned char> &table, size_t &offset, uint64_t *value)
+{
+	size_t used = 0;
+
+	if(offset >= table.size() || varint_decode(table.data() + offset, table.size() - offset, value, &used) == EXIT_FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+
+	offset += used;
+
+	return EXIT_SUCCESS;
+}
+
+static int text_index_pop_string(const std::vector<unsigned char> &table, size_t &offset, std::string &value)
+{
+	uint64_t size = 0;
+
+	if(text_index_pop_varint(table, offset, &size) == EXIT_FAILURE || size > table.size() - offset)
+	{
+		return EXIT_FAILURE;
+	}
+
+	value.assign((const char*)table.data() + offset, size);
+	offset += size;
+
+	return EXIT_SUCCESS;
+}
+
+static int text_index_file_read(const std::string &path, std::vector<unsigned char> &data)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if(file.is_open() == false)
+	{
+		return EXIT_FAILURE;
+	}
+
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	return EXIT_SUCCESS;
+}
+
+Text_Index::Text_Index()
+{
+	this->file_size = 0;
+	this->journal_file_size = 0;
+}
+
+void Text_Index::clear()
+{
+	this->postings.clear();
+	this->documents.clear();
+	this->journal.clear();
+	this->file_size = 0;
+	this->journal_file_size = 0;
+}
+
+void Text_Index::tokenize(std::string_view text, const std::function<void(std::string_view term)> &callback)
+{
+	char term[TEXT_INDEX_TERM_MAX_SIZE];
+	size_t size = 0;
+	bool in_term = false;
+
+	for(size_t i = 0; i <= text.size(); i++)
+	{
+		unsigned char c = i < text.size() ? (unsigned char)text[i] : ' ';
+
+		if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80)
+		{
+			in_term = true;
+		}
+
+		else if(c >= 'A' && c <= 'Z')
+		{
+			c = c - 'A' + 'a';
+			in_term = true;
+		}
+
+		else
+		{
+			if(in_term)
+			{
+				callback(std::string_view(term, size));
+			}
+
+			in_term = false;
+			size = 0;
+			continue;
+		}
+
+		if(size < sizeof(term))
+		{
+			term[size++] = (char)c;
+		}
+	}
+}
+
+void Text_Index::update(Type_ID privateID, std::initializer_list<std::string_view> texts)
+{
+	std::vector<std::string> terms;
+
+	for(std::string_view text : texts)
+	{
+		tokenize(text, [&terms](std::string_view term)
+		{
+			terms.emplace_back(term);
+		});
+	}
+
+	std::sort(terms.begin(), terms.end());
+	terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+	this->journal.push_back(Text_Index_Update);
+	text_index_push_varint(this->journal, uint64_t(privateID));
+	text_index_push_varint(this->journal, terms.size());
+
+	for(const std::string &term : terms)
+	{
+		text_index_push_varint(this->journal, term.size());
+		this->journal.insert(this->journal.end(), term.begin(), term.end());
+	}
+
+	this->remove_terms(privateID);
+	this->add_terms(privateID, terms);
+}
+
+void Text_Index::remove(Type_ID privateID)
+{
+	if(this->documents.count(privateID) == 0)
+	{
+		return void();
+	}
+
+	this->journal.push_back(Text_Index_Remove);
+	text_index_push_varint(this->journal, uint64_t(privateID));
+
+	this->remove_terms(privateID);
+}
+
+// terms have to be sorted and unique, they are moved from
+void Text_Index::add_terms(Type_ID privateID, std::vector<std::string> &terms)
+{
+	if(terms.empty())
+	{
+		return void();
+	}
+
+	std::vector<const std::string*> &keys = this->documents[privateID];
+	keys.reserve(terms.size());
+
+	for(std::string &term : terms)
+	{
+		auto result = this->postings.try_emplace(std::move(term));
+		std::vector<Type_ID> &list = result.first->second;
+		auto at = std::lower_bound(list.begin(), list.end(), privateID);
+
+		if(at == list.end() || *at != privateID)
+		{
+			list.insert(at, privateID);
+		}
+
+		keys.push_back(&result.first->first);
+	}
+}
+
+void Text_Index::remove_terms(Type_ID privateID)
+{
+	auto document = this->documents.find(privateID);
+
+	if(document == this->documents.end())
+	{
+		return void();
+	}
+
+	for(const std::string *key : document->second)
+	{
+		auto found = this->postings.find(*key);
+
+		if(found == this->postings.end())
+		{
+			continue;
+		}
+
+		std::vector<Type_ID> &list = found->second;
+		auto at = std::lower_bound(list.begin(), list.end(), privateID);
+
+		if(at != list.end() && *at == privateID)
+		{
+			list.erase(at);
+		}
+
+		if(list.empty())
+		{
+			this->postings.erase(found);
+		}
+	}
+
+	this->documents.erase(document);
+}
+
+std::vector<Type_ID> Text_Index::search(std::string_view query) const
+{
+	std::vector<const std::vector<Type_ID>*> lists;
+	bool missing = false;
+
+	tokenize(query, [&](std::string_view term)
+	{
+		auto found = this->postings.find(std::string(term));
+
+		if(found == this->postings.end())
+		{
+			missing = true;
+		}
+
+		else
+		{
+			lists.push_back(&found->second);
+		}
+	});
+
+	if(missing || lists.empty())
+	{
+		return std::vector<Type_ID>();
+	}
+
+	// Shortest first, so the intersections stay small
+	std::sort(lists.begin(), lists.end(), [](const std::vector<Type_ID> *a, const std::vector<Type_ID> *b)
+	{
+		return a->size() < b->size();
+	});
+
+	std::vector<Type_ID> result = *lists[0];
+	std::vector<Type_ID> buffer;
+
+	for(size_t i = 1; i < lists.size() && result.empty() == false; i++)
+	{
+		buffer.clear();
+		std::set_intersection(result.begin(), result.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(buffer));
+		result.swap(buffer);
+	}
+
+	return result;
+}
+
+size_t Text_Index::get_term_count() const
+{
+	return this->postings.size();
+}
+
+size_t Text_Index::get_document_count() const
+{
+	return this->documents.size();
+}
+
+/*
+ * A missing index is not an error when there is a journal. A torn record
+ * at the end of the journal is dropped and the index written again.
+ */
+int Text_Index::file_read(const std::string &path)
+{
+	this->clear();
+
+	std::vector<unsigned char> data;
+	bool found = false;
+
+	if(text_index_file_read(path, data) == EXIT_SUCCESS)
+	{
+		found = true;
+		size_t offset = sizeof(TEXT_INDEX_MAGIC) - 1;
+		uint64_t version = 0;
+		uint64_t term_count = 0;
+
+		if(data.size() < offset || std::memcmp(data.data(), TEXT_INDEX_MAGIC, offset) != 0 ||
+				text_index_pop_varint(data, offset, &version) == EXIT_FAILURE || version != TEXT_INDEX_VERSION ||
+				text_index_pop_varint(data, offset, &term_count) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		std::string term;
+
+		for(uint64_t i = 0; i < term_count; i++)
+		{
+			uint64_t count = 0;
+
+			if(text_index_pop_string(data, offset, term) == EXIT_FAILURE ||
+					text_index_pop_varint(data, offset, &count) == EXIT_FAILURE || count > data.size() - offset)
+			{
+				this->clear();
+				return EXIT_FAILURE;
+			}
+
+			auto result = this->postings.try_emplace(term);
+			std::vector<Type_ID> &list = result.first->second;
+			list.reserve(count);
+			uint64_t privateID = 0;
+
+			for(uint64_t j = 0; j < count; j++)
+			{
+				uint64_t delta = 0;
+
+				if(text_index_pop_varint(data, offset, &delta) == EXIT_FAILURE)
+				{
+					this->clear();
+					return EXIT_FAILURE;
+				}
+
+				privateID += delta;
+				list.push_back(Type_ID(privateID));
+				this->documents[Type_ID(privateID)].push_back(&result.first->first);
+			}
+		}
+
+		this->file_size = data.size();
+	}
+
+	if(text_index_file_read(path + TEXT_INDEX_JOURNAL_EXTENSION, data) == EXIT_SUCCESS)
+	{
+		found = true;
+		this->journal_file_size = data.size();
+
+		// Appending after a torn record would lose the new records
+		if(this->journal_replay(data) == EXIT_FAILURE)
+		{
+			this->file_write(path);
+		}
+	}
+
+	return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int Text_Index::journal_replay(const std::vector<unsigned char> &data)
+{
+	size_t offset = 0;
+	std::vector<std::string> terms;
+
+	while(offset < data.size())
+	{
+		unsigned char record = data[offset++];
+		uint64_t privateID = 0;
+
+		if(text_index_pop_varint(data, offset, &privateID) == EXIT_FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+
+		if(record == Text_Index_Remove)
+		{
+			this->remove_terms(Type_ID(privateID));
+			continue;
+		}
+
+		uint64_t count = 0;
+
+		if(record != Text_Index_Update || text_index_pop_varint(data, offset, &count) == EXIT_FAILURE || count > data.size() - offset)
+		{
+			return EXIT_FAILURE;
+		}
+
+		terms.resize(count);
+
+		for(std::string &term : terms)
+		{
+			if(text_index_pop_string(data, offset, term) == EXIT_FAILURE)
+			{
+				return EXIT_FAILURE;
+			}
+		}
+
+		this->remove_terms(Type_ID(privateID));
+		this->add_terms(Type_ID(privateID), terms);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Text_Index::file_write(const std::string &path)
+{
+	std::vector<unsigned char> data(TEXT_INDEX_MAGIC, TEXT_INDEX_MAGIC + sizeof(TEXT_INDEX_MAGIC) - 1);
+	text_index_push_varint(data, TEXT_INDEX_VERSION);
+	text_index_push_varint(data, this->postings.size());
+
+	for(const auto &posting : this->postings)
+	{
+		text_index_push_varint(data, posting.first.size());
+		data.insert(data.end(), posting.first.begin(), posting.first.end());
+		text_index_push_varint(data, posting.second.size());
+
+		uint64_t previous = 0;
+
+		for(Type_ID privateID : posting.second)
+		{
+			text_index_push_varint(data, uint64_t(privateID) - previous);
+			previous = uint64_t(privateID);
+		}
+	}
+
+	// Replaced at once, the old index and journal stay valid until then
+	std::string temporary = path + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	file.write((const char*)data.data(), data.size());
+	file.close();
+
+	if(file.fail() || std::rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temporary.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::remove((path + TEXT_INDEX_JOURNAL_EXTENSION).c_str());
+
+	this->journal.clear();
+	this->file_size = data.size();
+	this->journal_file_size = 0;
+
+	return EXIT_SUCCESS;
+}
+
+int Text_Index::file_update(const std::string &path)
+{
+	if(this->journal.empty())
+	{
+		return EXIT_SUCCESS;
+	}
+
+	if(this->journal_file_size + this->journal.size() > std::max<size_t>(this->file_size, TEXT_INDEX_JOURNAL_MIN_SIZE))
+	{
+		return this->file_write(path);
+	}
+
+	std::ofstream file(path + TEXT_INDEX_JOURNAL_EXTENSION, std::ios::binary | std::ios::app);
+	file.write((const char*)this->journal.data(), this->journal.size());
+	file.close();
+
+	if(file.fail())
+	{
+		return EXIT_FAILURE;
+	}
+
+	this->journal_file_size += this->journal.size();
+	this->journal.clear();
+
+	return EXIT_SUCCESS;
+}
@@ -1,6 +1,18 @@
+#include <Common_Types.h>
 #include <helpers_tinyxml2.h>
 #include <XML_Types.h>
 
+#include <algorithm>
+
+#ifdef _ZLIB
+#include <zlib.h>
+#include <Common_Functions.h>
+#endif
+
+#ifdef _ZSTD
+#include <Compress_zstd.h>
+#endif
+
 bool string_to_bool(std::string value)
 {
   if(value == XML_STRING_TRUE || value == XML_STRING_TRUE_SMALL)
@@ -46,3 +58,216 @@ std::string get_std_string(tinyxml2::XMLElement *element)
   return std::string();
 }
 
+
+std::string_view get_string_view(tinyxml2::XMLElement *element)
+{
+  if(element == nullptr)
+  {
+    return std::string_view();
+  }
+
+  const char *value = (const char*) element->GetText();
+
+  if(value != nullptr)
+  {
+    return std::string_view(value);
+  }
+
+  return std::string_view();
+}
+
+void base64_print(std::string_view data, tinyxml2::XMLPrinter *printer)
+{
+  Base64_Encoder encoder([printer](const char *text, size_t size)
+  {
+    if(size > 0)
+    {
+      printer->PushText(text);
+    }
+  });
+
+  encoder.update(data);
+  encoder.finish();
+}
+
+int base64_read(tinyxml2::XMLElement *element, Base64_Decoder::Sink sink)
+{
+  Base64_Decoder decoder(sink);
+
+  if(decoder.update(get_string_view(element)) == EXIT_FAILURE)
+  {
+    return EXIT_FAILURE;
+  }
+
+  return decoder.finish();
+}
+
+#ifdef _ZLIB
+void xml_zlib_compress_print(std::string_view xml, tinyxml2::XMLPrinter *printer, XML_Options_Table &options)
+{
+  printer->OpenElement(XML_STRING_COMPRESSED_ZLIB, options.no_empty_space);
+
+  z_stream stream = {};
+
+  if(deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    printer->CloseElement(options.no_empty_space);
+    return void();
+  }
+
+  Base64_Encoder encoder([printer](const char *text, size_t size)
+  {
+    if(size > 0)
+    {
+      printer->PushText(text);
+    }
+  });
+
+  unsigned char chunk[16384];
+  int flush = Z_NO_FLUSH;
+
+  stream.next_in = (Bytef*)xml.data();
+
+  // avail_in is 32-bit, larger documents are fed in parts
+  while(flush != Z_FINISH)
+  {
+    size_t consumed = (const char*)stream.next_in - xml.data();
+    size_t left = xml.size() - consumed;
+
+    stream.avail_in = (uInt)std::min<size_t>(left, 1u << 30);
+    flush = (left == stream.avail_in) ? Z_FINISH : Z_NO_FLUSH;
+
+    do
+    {
+      stream.next_out = chunk;
+      stream.avail_out = sizeof(chunk);
+      deflate(&stream, flush);
+      encoder.update(chunk, sizeof(chunk) - stream.avail_out);
+    }
+    while(stream.avail_out == 0);
+  }
+
+  deflateEnd(&stream);
+  encoder.finish();
+
+  printer->CloseElement(options.no_empty_space);
+}
+
+std::string xml_zlib_read_decompress(tinyxml2::XMLElement *element)
+{
+  std::string xml;
+  z_stream stream = {};
+
+  if(inflateInit(&stream) != Z_OK)
+  {
+    return xml;
+  }
+
+  unsigned char chunk[16384];
+  int status = Z_OK;
+  bool too_large = false;
+
+  auto append = [&]()
+  {
+    size_t size = sizeof(chunk) - stream.avail_out;
+
+    if(xml.size() + size > XML_ZLIB_DECOMPRESS_MAX_SIZE)
+    {
+      too_large = true;
+      status = Z_MEM_ERROR;
+      return void();
+    }
+
+    xml.append((const char*)chunk, size);
+  };
+
+  int decoded = base64_read(element, [&](const unsigned char *data, size_t size)
+  {
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = (uInt)size;
+
+    while(stream.avail_in > 0 && status == Z_OK)
+    {
+      stream.next_out = chunk;
+      stream.avail_out = sizeof(chunk);
+      status = inflate(&stream, Z_NO_FLUSH);
+
+      if(status == Z_OK || status == Z_STREAM_END)
+      {
+        append();
+      }
+    }
+  });
+
+  // inflate may hold output when the input ended on a chunk boundary
+  while(status == Z_OK && decoded == EXIT_SUCCESS)
+  {
+    stream.next_out = chunk;
+    stream.avail_out = sizeof(chunk);
+    status = inflate(&stream, Z_FINISH);
+
+    if(status == Z_OK || status == Z_STREAM_END || status == Z_BUF_ERROR)
+    {
+      append();
+    }
+
+    if(status == Z_BUF_ERROR)
+    {
+      break;
+    }
+  }
+
+  inflateEnd(&stream);
+
+  if(decoded == EXIT_FAILURE || status != Z_STREAM_END)
+  {
+    xml.clear();
+  }
+
+  // Not a zlib stream, read as before the streaming reader
+  if(decoded == EXIT_SUCCESS && status == Z_DATA_ERROR && too_large == false)
+  {
+    std::vector<uint8_t> data = base64Decode(get_std_string(element));
+
+    if(data.empty() == false)
+    {
+      xml = std_string_decompress(data);
+    }
+  }
+
+  return xml;
+}
+#endif
+
+#ifdef _ZSTD
+int xml_zstd_compress_print(std::string_view xml, tinyxml2::XMLPrinter *printer, XML_Options_Table &options, Zstd_Dictionary *dictionary)
+{
+  std::string compressed;
+
+  if(dictionary == nullptr || dictionary->compress(xml, compressed) == EXIT_FAILURE)
+  {
+    return EXIT_FAILURE;
+  }
+
+  printer->OpenElement(XML_STRING_COMPRESSED_ZSTD, options.no_empty_space);
+  base64_print(compressed, printer);
+  printer->CloseElement(options.no_empty_space);
+
+  return EXIT_SUCCESS;
+}
+
+std::string xml_zstd_read_decompress(tinyxml2::XMLElement *element, Zstd_Dictionary *dictionary)
+{
+  std::string xml;
+  std::string compressed;
+
+  if(dictionary == nullptr || base64Decode(get_string_view(element), compressed) == EXIT_FAILURE)
+  {
+    return xml;
+  }
+
+  dictionary->decompress(compressed, xml);
+
+  return xml;
+}
+#endif